@@ -0,0 +1,506 @@
+#include "ret-exception.hpp"
+#include "ret-exception-shared.hpp"
+#include "ret-exception-retry.hpp"
+#include "ret-exception-io.hpp"
+#include "ret-exception-uring.hpp"
+#include "ret-exception-parse.hpp"
+#include "ret-exception-charconv.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+template <class T>
+static void do_not_optimize(const T &val)
+{
+    asm volatile("" : : "r,m"(val) : "memory");
+}
+
+/**
+ * @return nanoseconds per call of f.
+ */
+template <class F>
+static double bench(std::size_t iterations, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i != iterations; ++i)
+        f(i);
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void report(const char *name, double ns)
+{
+    std::printf("%-48s %8.3f ns/call\n", name, ns);
+}
+
+static void report_throughput(const char *name, std::size_t bytes, double ns)
+{
+    std::printf("%-48s %8.3f GB/s\n", name, bytes / ns);
+}
+
+static constexpr std::size_t iterations = 50'000'000;
+
+/* Per-call cost of each policy */
+
+template <class Policy>
+__attribute__((noinline)) 
+static auto policy_f(std::size_t i) -> Ret_except_p<Policy, std::size_t, int>
+{
+    if (i % 1024 == 1023)
+        return {-1};
+    return i;
+}
+
+template <class Policy>
+static void bench_policy(const char *name)
+{
+    report(name, bench(iterations, [](std::size_t i) {
+        std::size_t sum = 0;
+
+        auto r = policy_f<Policy>(i);
+        if (r.has_exception_set())
+            r.Catch([&](int e) { sum += e; });
+        else
+            sum += r.get_return_value();
+
+        do_not_optimize(sum);
+    }));
+}
+
+/* Chained Catch vs multi-handler Catch */
+
+template <int i>
+struct route_error {
+    int val;
+};
+
+using router_result = Ret_except<std::size_t, route_error<0>, route_error<1>, route_error<2>, route_error<3>, route_error<4>,
+                                 route_error<5>, route_error<6>, route_error<7>, route_error<8>, route_error<9>>;
+
+template <int i = 0>
+static auto make_error(std::size_t n) -> router_result
+{
+    if constexpr(i == 9)
+        return {route_error<9>{9}};
+    else {
+        if (n % 10 == i)
+            return {route_error<i>{i}};
+        return make_error<i + 1>(n);
+    }
+}
+
+__attribute__((noinline))
+static auto route(std::size_t n) -> router_result
+{
+    return make_error(n);
+}
+
+static void bench_catch()
+{
+    report("catch: 10 chained Catch", bench(iterations, [](std::size_t n) {
+        int sum = 0;
+        route(n)
+            .Catch([&](route_error<0> e) { sum += e.val; })
+            .Catch([&](route_error<1> e) { sum += e.val; })
+            .Catch([&](route_error<2> e) { sum += e.val; })
+            .Catch([&](route_error<3> e) { sum += e.val; })
+            .Catch([&](route_error<4> e) { sum += e.val; })
+            .Catch([&](route_error<5> e) { sum += e.val; })
+            .Catch([&](route_error<6> e) { sum += e.val; })
+            .Catch([&](route_error<7> e) { sum += e.val; })
+            .Catch([&](route_error<8> e) { sum += e.val; })
+            .Catch([&](route_error<9> e) { sum += e.val; });
+        do_not_optimize(sum);
+    }));
+
+    report("catch: 1 Catch with 10 handlers", bench(iterations, [](std::size_t n) {
+        int sum = 0;
+        route(n).Catch(
+            [&](route_error<0> e) { sum += e.val; },
+            [&](route_error<1> e) { sum += e.val; },
+            [&](route_error<2> e) { sum += e.val; },
+            [&](route_error<3> e) { sum += e.val; },
+            [&](route_error<4> e) { sum += e.val; },
+            [&](route_error<5> e) { sum += e.val; },
+            [&](route_error<6> e) { sum += e.val; },
+            [&](route_error<7> e) { sum += e.val; },
+            [&](route_error<8> e) { sum += e.val; },
+            [&](route_error<9> e) { sum += e.val; });
+        do_not_optimize(sum);
+    }));
+}
+
+/* Dispatch through any_error against the fully typed form */
+
+using erased_router_result = Ret_except<std::size_t, ret_exception::any_error>;
+
+__attribute__((noinline))
+static auto route_erased(std::size_t n) -> erased_router_result
+{
+    return {make_error(n)};
+}
+
+static void bench_any_error()
+{
+    report("any_error: 10 chained Catch", bench(iterations, [](std::size_t n) {
+        int sum = 0;
+        route_erased(n)
+            .Catch([&](route_error<0> e) { sum += e.val; })
+            .Catch([&](route_error<1> e) { sum += e.val; })
+            .Catch([&](route_error<2> e) { sum += e.val; })
+            .Catch([&](route_error<3> e) { sum += e.val; })
+            .Catch([&](route_error<4> e) { sum += e.val; })
+            .Catch([&](route_error<5> e) { sum += e.val; })
+            .Catch([&](route_error<6> e) { sum += e.val; })
+            .Catch([&](route_error<7> e) { sum += e.val; })
+            .Catch([&](route_error<8> e) { sum += e.val; })
+            .Catch([&](route_error<9> e) { sum += e.val; });
+        do_not_optimize(sum);
+    }));
+
+    report("any_error: get_error_if of 1 type", bench(iterations, [](std::size_t n) {
+        auto r = route_erased(n);
+        int val = 0;
+        if (auto *e = r.get_error_if<route_error<9>>())
+            val = e->val;
+        r.Catch([](const ret_exception::any_error&) {});
+        do_not_optimize(val);
+    }));
+
+    report("typed: get_error_if of 1 type", bench(iterations, [](std::size_t n) {
+        auto r = route(n);
+        int val = 0;
+        if (auto *e = r.get_error_if<route_error<9>>())
+            val = e->val;
+        r.Catch([](const auto&) {});
+        do_not_optimize(val);
+    }));
+}
+
+/* Error storm whose payload is never read */
+
+__attribute__((noinline))
+static auto fail_eager(std::size_t n) -> Ret_except<std::size_t, std::runtime_error>
+{
+    return {std::runtime_error{"request " + std::to_string(n) + " failed: upstream timed out"}};
+}
+
+__attribute__((noinline))
+static auto fail_deferred(std::size_t n) -> Ret_except<std::size_t, ret_exception::deferred<std::runtime_error>>
+{
+    return {ret_exception::deferred<std::runtime_error>{[n] {
+        return std::runtime_error{"request " + std::to_string(n) + " failed: upstream timed out"};
+    }}};
+}
+
+static void bench_deferred()
+{
+    report("deferred: eager std::runtime_error, dropped", bench(iterations / 10, [](std::size_t n) {
+        auto r = fail_eager(n);
+        do_not_optimize(r.has_exception_type<std::runtime_error>());
+        r.Catch([](const auto&) {});
+    }));
+
+    report("deferred: deferred<std::runtime_error>, dropped", bench(iterations / 10, [](std::size_t n) {
+        auto r = fail_deferred(n);
+        do_not_optimize(r.has_exception_type<std::runtime_error>());
+        r.Catch([](const auto&) {});
+    }));
+}
+
+/* Context attached by each frame an error propagates through */
+
+using frame_result = Ret_except<std::size_t, std::runtime_error>;
+
+__attribute__((noinline))
+static auto innermost(std::size_t n) -> frame_result
+{
+    if (n % 2)
+        return {std::runtime_error{"timed out"}};
+    return {n};
+}
+
+__attribute__((noinline))
+static auto frame_wrapped(std::size_t n) -> frame_result
+{
+    auto r = innermost(n);
+    if (auto *e = r.get_error_if<std::runtime_error>())
+        return {std::runtime_error{std::string{"in request "} + std::to_string(n) + ": " + e->what()}};
+    return r;
+}
+
+__attribute__((noinline))
+static auto frame_context(std::size_t n) -> frame_result
+{
+    return innermost(n).add_context({"in request", static_cast<long long>(n)});
+}
+
+static void bench_context()
+{
+    report("context: std::runtime_error rewrapped", bench(iterations / 10, [](std::size_t n) {
+        frame_wrapped(n).Catch([](const auto&) {});
+    }));
+
+    report("context: add_context", bench(iterations / 10, [](std::size_t n) {
+        frame_context(n).Catch([](const auto&) {});
+    }));
+}
+
+/* Readers of shared_result under contention */
+
+static void bench_shared_result()
+{
+    ret_exception::shared_result<std::size_t, int> cell;
+    (void) cell.publish(Ret_except<std::size_t, int>{std::size_t{1}});
+
+    for (unsigned nthreads = 1; nthreads <= 64; nthreads *= 2) {
+        constexpr std::size_t reads = 10'000'000;
+
+        std::atomic<unsigned> started{0};
+        std::vector<std::thread> readers;
+        auto start = std::chrono::steady_clock::now();
+
+        for (unsigned i = 0; i != nthreads; ++i)
+            readers.emplace_back([&] {
+                ++started;
+                while (started.load() != nthreads)
+                    ;
+
+                std::size_t sum = 0;
+                for (std::size_t j = 0; j != reads; ++j) {
+                    do_not_optimize(cell);
+                    sum += *cell.get_if();
+                }
+                do_not_optimize(sum);
+            });
+        for (auto &reader: readers)
+            reader.join();
+
+        auto end = std::chrono::steady_clock::now();
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "shared_result: get_if with %2u readers", nthreads);
+        report(name, std::chrono::duration<double, std::nano>(end - start).count() / (reads * nthreads));
+    }
+}
+
+/* Latency distribution of retry */
+
+struct would_block {};
+struct permission_denied {};
+
+using lock_result = Ret_except<int, would_block, permission_denied>;
+
+__attribute__((noinline))
+static auto try_lock(std::size_t n) -> lock_result
+{
+    // Fails 1/4 of the calls, a few of them with non-retryable exception
+    if (n % 4 == 0)
+        return {would_block{}};
+    if (n % 1021 == 0)
+        return {permission_denied{}};
+    return 0;
+}
+
+static void bench_retry()
+{
+    constexpr std::size_t calls = 100'000;
+
+    ret_exception::retry_policy policy;
+    policy.max_attempts = 3;
+    policy.initial_backoff = std::chrono::microseconds{1};
+
+    std::vector<double> latencies;
+    latencies.reserve(calls);
+
+    std::size_t n = 0;
+    for (std::size_t i = 0; i != calls; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto r = ret_exception::retry<would_block>(policy, [&] {
+            return try_lock(n++);
+        });
+        r.Catch([](const auto&) {});
+        auto end = std::chrono::steady_clock::now();
+
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    for (double percentile: {50.0, 90.0, 99.0, 99.9}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "retry: p%g latency", percentile);
+        report(name, latencies[static_cast<std::size_t>(percentile / 100 * (calls - 1))]);
+    }
+}
+
+/* Overhead of io wrappers over raw syscalls */
+
+static void bench_io()
+{
+    constexpr std::size_t reads = 1'000'000;
+
+    int fd = ::open("/dev/zero", O_RDONLY);
+    if (fd == -1)
+        return;
+
+    static char buf[4096];
+
+    report("io: raw read(2) of 4KiB", bench(reads, [&](std::size_t) {
+        do_not_optimize(::read(fd, buf, sizeof(buf)));
+    }));
+    report("io: ret_exception::io::read of 4KiB", bench(reads, [&](std::size_t) {
+        do_not_optimize(ret_exception::io::read(fd, buf).value_or(0));
+    }));
+
+    ::close(fd);
+}
+
+/* Syscalls saved by batching reads via io_uring */
+
+static void bench_uring()
+{
+    constexpr std::size_t batches = 20'000;
+    constexpr unsigned batch_size = 64;
+
+    int fd = ::open("/dev/zero", O_RDONLY);
+    if (fd == -1)
+        return;
+
+    static char bufs[batch_size][512];
+
+    report("uring: pread(2) of 512B", bench(batches * batch_size, [&](std::size_t) {
+        do_not_optimize(::pread(fd, bufs[0], sizeof(bufs[0]), 0));
+    }));
+
+    ret_exception::io::uring<> ring{batch_size};
+    decltype(ring)::result_type results[batch_size];
+
+    double ns = bench(batches, [&](std::size_t) {
+        for (unsigned i = 0; i != batch_size; ++i)
+            (void) ring.prep_read(fd, bufs[i], sizeof(bufs[i]), 0, results[i]);
+        ring.wait_all().Catch([](const auto&) {});
+
+        for (auto &result: results)
+            do_not_optimize(result.value_or(0));
+    });
+    report(ring.is_fallback() ? "uring: fallback of 512B, batch of 64" : "uring: io_uring of 512B, batch of 64",
+           ns / batch_size);
+
+    ::close(fd);
+}
+
+/* Throughput of number parsing over newline separated records */
+
+template <class F>
+static void bench_parse_input(const char *name, const std::string &input, F &&f)
+{
+    constexpr std::size_t rounds = 10;
+    report_throughput(name, input.size() * rounds, bench(rounds, [&](std::size_t) {
+        f(input);
+    }) * rounds);
+}
+
+static void bench_parse()
+{
+    namespace parse = ret_exception::parse;
+
+    std::mt19937_64 rng{42};
+    std::string ints, floats;
+    char buf[64];
+    for (std::size_t i = 0; i != 1'000'000; ++i) {
+        ints += std::to_string(static_cast<std::int64_t>(rng() >> (rng() % 64)) - (1LL << 30));
+        ints += '\n';
+
+        std::snprintf(buf, sizeof(buf), "%.*f\n", static_cast<int>(rng() % 8),
+                      static_cast<double>(rng() % 100'000'000) / 1000);
+        floats += buf;
+    }
+
+    bench_parse_input("parse: std::from_chars int64", ints, [](const std::string &input) {
+        std::int64_t sum = 0;
+        const char *p = input.data(), *end = p + input.size();
+        while (p != end) {
+            std::int64_t val = 0;
+            p = std::from_chars(p, end, val).ptr + 1;
+            sum += val;
+        }
+        do_not_optimize(sum);
+    });
+    bench_parse_input("parse: parse::parse_int<int64>", ints, [](const std::string &input) {
+        std::int64_t sum = 0;
+        (void) parse::for_each_record(input, '\n', [&](parse::cursor &c) {
+            sum += parse::parse_int<std::int64_t>(c).value_or(0);
+            return Ret_except<void>{};
+        });
+        do_not_optimize(sum);
+    });
+
+    std::vector<std::int64_t> int_values(1'000'000);
+    bench_parse_input("charconv: from_chars_bulk<int64>", ints, [&](const std::string &input) {
+        auto n = ret_exception::charconv::from_chars_bulk(input, '\n', int_values.data(), int_values.size());
+        do_not_optimize(n.value_or(0));
+    });
+
+    bench_parse_input("parse: strtod", floats, [](const std::string &input) {
+        double sum = 0;
+        for (const char *p = input.c_str(); *p; ++p)
+            sum += std::strtod(p, const_cast<char**>(&p));
+        do_not_optimize(sum);
+    });
+    bench_parse_input("parse: std::from_chars double", floats, [](const std::string &input) {
+        double sum = 0;
+        const char *p = input.data(), *end = p + input.size();
+        while (p != end) {
+            double val = 0;
+            p = std::from_chars(p, end, val).ptr + 1;
+            sum += val;
+        }
+        do_not_optimize(sum);
+    });
+    std::vector<double> float_values(1'000'000);
+    bench_parse_input("charconv: from_chars_bulk<double>", floats, [&](const std::string &input) {
+        auto n = ret_exception::charconv::from_chars_bulk(input, '\n', float_values.data(), float_values.size());
+        do_not_optimize(n.value_or(0));
+    });
+    bench_parse_input("parse: parse::parse_float<double>", floats, [](const std::string &input) {
+        double sum = 0;
+        (void) parse::for_each_record(input, '\n', [&](parse::cursor &c) {
+            sum += parse::parse_float(c).value_or(0);
+            return Ret_except<void>{};
+        });
+        do_not_optimize(sum);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    bench_policy<ret_exception::enforce_policy>("policy: enforce_policy");
+    bench_policy<ret_exception::debug_policy>("policy: debug_policy (NDEBUG)");
+    bench_policy<ret_exception::checked_once_policy>("policy: checked_once_policy");
+
+    bench_catch();
+    bench_any_error();
+    bench_deferred();
+    bench_context();
+    bench_shared_result();
+    bench_retry();
+    bench_io();
+    bench_uring();
+    bench_parse();
+
+    return 0;
+}
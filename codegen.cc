@@ -0,0 +1,79 @@
+/**
+ * Compiled to codegen.s by `make codegen` to inspect the code generated for the
+ * accessors of Ret_except, and by `make codesize` to compare the size of Catch on
+ * typed exceptions against any_error.
+ */
+#include "ret-exception.hpp"
+
+struct not_found {
+    int key;
+};
+
+using lookup_result = Ret_except<int, not_found>;
+
+int value_or(lookup_result &r)
+{
+    return r.value_or(-1);
+}
+
+const int* get_if(const lookup_result &r)
+{
+    return r.get_if();
+}
+
+const not_found* get_error_if(lookup_result &r)
+{
+    return r.get_error_if<not_found>();
+}
+
+static lookup_result lookup(int key)
+{
+    if (key < 0)
+        return {not_found{key}};
+    return key * 2;
+}
+
+int sum_lookups(int n)
+{
+    int sum = 0;
+    for (int i = -n; i != n; ++i)
+        sum += lookup(i).Catch_all_exhaustive([](not_found) { return 0; });
+    return sum;
+}
+
+template <int i>
+struct route_error {
+    int val;
+};
+
+using typed_route_result = Ret_except<int, route_error<0>, route_error<1>, route_error<2>, route_error<3>,
+                                      route_error<4>, route_error<5>, route_error<6>, route_error<7>>;
+using erased_route_result = Ret_except<int, ret_exception::any_error>;
+
+int catch_typed(typed_route_result &r)
+{
+    int sum = 0;
+    r.Catch([&](route_error<0> e) { sum += e.val; },
+            [&](route_error<3> e) { sum += e.val; },
+            [&](const auto&) { sum = -1; });
+    return sum;
+}
+
+int catch_erased(erased_route_result &r)
+{
+    int sum = 0;
+    r.Catch([&](route_error<0> e) { sum += e.val; },
+            [&](route_error<3> e) { sum += e.val; },
+            [&](const auto&) { sum = -1; });
+    return sum;
+}
+
+lookup_result find(int key)
+{
+    return lookup(key);
+}
+
+lookup_result find_with_context(int key)
+{
+    return lookup(key).add_context({"in find", key});
+}
@@ -0,0 +1,450 @@
+#ifndef  __return_exception_charconv_HPP__
+# define __return_exception_charconv_HPP__
+
+# include "ret-exception.hpp"
+
+# include <charconv>
+# include <cmath>
+# include <limits>
+# include <string_view>
+# include <system_error>
+# include <type_traits>
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+
+/**
+ * Locale-free conversions between strings and numbers in the format of std::from_chars
+ * and std::to_chars, returning Ret_except instead of std::errc.
+ */
+namespace ret_exception::charconv {
+/**
+ * The input does not start with a number, or is followed by unexpected characters.
+ */
+struct invalid_argument_t {
+    /**
+     * Position of the first character not accepted.
+     */
+    std::size_t position;
+
+    auto what() const noexcept -> const char*
+    {
+        return "Invalid argument";
+    }
+};
+
+/**
+ * The number does not fit in the type requested, or the output buffer is too small.
+ */
+struct out_of_range_t {
+    /**
+     * Position of the number, or the size of the output buffer.
+     */
+    std::size_t position;
+
+    auto what() const noexcept -> const char*
+    {
+        return "Out of range";
+    }
+};
+
+static_assert(std::is_trivially_copyable<invalid_argument_t>::value);
+static_assert(std::is_trivially_copyable<out_of_range_t>::value);
+
+template <class T>
+using from_chars_result = Ret_except<T, invalid_argument_t, out_of_range_t>;
+
+namespace impl {
+struct digits_t {
+    std::uint64_t value;
+    std::size_t len;
+    bool is_overflow;
+};
+
+inline auto load8(const char *p) noexcept -> std::uint64_t
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @return 0 in every byte that is a digit, non-zero otherwise.
+ *
+ * The bytes up to the first non-digit are always right.
+ */
+inline auto non_digits(std::uint64_t v) noexcept -> std::uint64_t
+{
+    return ((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ^
+           0x3333333333333333;
+}
+
+/**
+ * Converts 8 digits loaded in little endian with 3 multiplications instead of 8.
+ */
+inline auto parse_eight_digits(std::uint64_t v) noexcept -> std::uint32_t
+{
+    v -= 0x3030303030303030;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+/**
+ * Parse the longest sequence of decimal digits starting at p.
+ *
+ * @param init value accumulated so far, the digits parsed are appended to it.
+ */
+inline auto parse_digits(const char *p, const char *end, std::uint64_t init = 0) noexcept -> digits_t
+{
+    const char *begin = p;
+    std::uint64_t value = init;
+    bool is_overflow = false;
+
+# if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    constexpr std::uint64_t pow10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    };
+
+    while (end - p >= 8) {
+        std::uint64_t v = load8(p);
+        std::uint64_t mask = non_digits(v);
+        unsigned len = mask ? __builtin_ctzll(mask) / 8 : 8;
+        if (len == 0)
+            break;
+
+        // Pad the digits with leading '0'
+        if (len != 8)
+            v = (v << (64 - 8 * len)) | (0x3030303030303030 >> (8 * len));
+
+        is_overflow |= __builtin_mul_overflow(value, pow10[len], &value);
+        is_overflow |= __builtin_add_overflow(value, parse_eight_digits(v), &value);
+        p += len;
+
+        if (len != 8)
+            return {value, static_cast<std::size_t>(p - begin), is_overflow};
+    }
+# endif
+
+    for (; p != end && static_cast<unsigned char>(*p - '0') < 10; ++p) {
+        is_overflow |= __builtin_mul_overflow(value, std::uint64_t{10}, &value);
+        is_overflow |= __builtin_add_overflow(value, static_cast<std::uint64_t>(*p - '0'), &value);
+    }
+
+    return {value, static_cast<std::size_t>(p - begin), is_overflow};
+}
+
+constexpr double pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/**
+ * Largest power of 10 exactly representable in T.
+ */
+template <class T>
+constexpr int max_exact_pow10 = std::is_same<T, float>::value ? 10 : 22;
+
+/**
+ * @param ptr set to the first character not parsed on success.
+ */
+template <class T>
+auto parse_int(const char *first, const char *last, const char *&ptr) noexcept -> from_chars_result<T>
+{
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint64_t),
+                  "T must be an integer of at most 64 bits");
+
+    const char *p = first;
+
+    bool is_negative = false;
+    if constexpr(std::is_signed<T>::value) {
+        if (p != last && *p == '-') {
+            is_negative = true;
+            ++p;
+        }
+    }
+
+    auto digits = parse_digits(p, last);
+    if (digits.len == 0)
+        return {invalid_argument_t{0}};
+
+    using U = typename std::make_unsigned<T>::type;
+    std::uint64_t max = static_cast<U>(std::numeric_limits<T>::max()) + std::uint64_t{is_negative};
+    if (digits.is_overflow || digits.value > max)
+        return {out_of_range_t{0}};
+
+    ptr = p + digits.len;
+    if (is_negative)
+        return {static_cast<T>(-static_cast<std::int64_t>(digits.value - 1) - 1)};
+    return {static_cast<T>(digits.value)};
+}
+
+/**
+ * If the mantissa and the exponent are small enough for the result to be computed exactly
+ * by one multiplication or division, it is done without calling std::from_chars.
+ *
+ * @param ptr set to the first character not parsed on success.
+ */
+template <class T>
+auto parse_float(const char *first, const char *last, const char *&ptr) noexcept -> from_chars_result<T>
+{
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                  "T must be float or double");
+
+    const char *p = first;
+
+    bool is_negative = p != last && *p == '-';
+    p += is_negative;
+
+    auto mantissa = parse_digits(p, last);
+    std::size_t integer_len = mantissa.len;
+    p += integer_len;
+
+    std::size_t fraction_len = 0;
+    if (p != last && *p == '.') {
+        bool is_integer_overflow = mantissa.is_overflow;
+
+        mantissa = parse_digits(p + 1, last, mantissa.value);
+        mantissa.is_overflow |= is_integer_overflow;
+        fraction_len = mantissa.len;
+        p += 1 + fraction_len;
+    }
+
+    std::int64_t exponent = 0;
+    bool is_exponent_overflow = false;
+    if (p != last && (*p | 0x20) == 'e') {
+        const char *q = p + 1;
+        bool is_exponent_negative = q != last && *q == '-';
+        q += q != last && (*q == '-' || *q == '+');
+
+        auto e = parse_digits(q, last);
+        if (e.len != 0) {
+            is_exponent_overflow = e.is_overflow || e.value > 1000000;
+            exponent = is_exponent_negative ? -static_cast<std::int64_t>(e.value) :
+                                              static_cast<std::int64_t>(e.value);
+            p = q + e.len;
+        }
+    }
+    exponent -= static_cast<std::int64_t>(fraction_len);
+
+    constexpr std::uint64_t max_exact_mantissa = std::uint64_t{1} << std::numeric_limits<T>::digits;
+    constexpr int max_pow10 = max_exact_pow10<T>;
+
+    if (integer_len + fraction_len != 0 && !mantissa.is_overflow && !is_exponent_overflow &&
+        mantissa.value <= max_exact_mantissa && exponent >= -max_pow10 && exponent <= max_pow10) {
+        T value = static_cast<T>(mantissa.value);
+        if (exponent < 0)
+            value /= static_cast<T>(pow10[-exponent]);
+        else
+            value *= static_cast<T>(pow10[exponent]);
+
+        ptr = p;
+        return {is_negative ? -value : value};
+    }
+
+    T value;
+    auto [end, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::invalid_argument)
+        return {invalid_argument_t{0}};
+    if (ec == std::errc::result_out_of_range)
+        return {out_of_range_t{0}};
+
+    ptr = end;
+    return {value};
+}
+
+template <class F>
+constexpr auto pow2(int n) noexcept -> F
+{
+    F result = 1;
+    while (n-- > 0)
+        result *= 2;
+    return result;
+}
+
+template <class T>
+auto parse_number(const char *first, const char *last, const char *&ptr) noexcept -> from_chars_result<T>
+{
+    if constexpr(std::is_floating_point<T>::value)
+        return parse_float<T>(first, last, ptr);
+    else
+        return parse_int<T>(first, last, ptr);
+}
+} /* namespace impl */
+
+/**
+ * Parse a decimal integer with an optional '-' if T is signed, or a float in the general format,
+ * following std::from_chars.
+ *
+ * Decimal digits are converted 8 at a time if possible.
+ *
+ * @param consumed if not nullptr, set to the number of characters parsed on success.
+ *                 Otherwise, s must only contain the number.
+ */
+template <class T>
+auto from_chars(std::string_view s, std::size_t *consumed = nullptr) noexcept -> from_chars_result<T>
+{
+    const char *first = s.data();
+    const char *last = first + s.size();
+    const char *ptr = first;
+
+    auto r = impl::parse_number<T>(first, last, ptr);
+    if (r.has_exception_set())
+        return r;
+
+    if (consumed)
+        *consumed = ptr - first;
+    else if (ptr != last)
+        return {invalid_argument_t{static_cast<std::size_t>(ptr - first)}};
+    return r;
+}
+
+/**
+ * Parse an integer in base, which is only converted 8 digits at a time if base == 10.
+ */
+template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+auto from_chars(std::string_view s, std::size_t *consumed, int base) noexcept -> from_chars_result<T>
+{
+    if (base == 10)
+        return from_chars<T>(s, consumed);
+
+    const char *first = s.data();
+    const char *last = first + s.size();
+
+    T value;
+    auto [ptr, ec] = std::from_chars(first, last, value, base);
+    if (ec == std::errc::invalid_argument)
+        return {invalid_argument_t{0}};
+    if (ec == std::errc::result_out_of_range)
+        return {out_of_range_t{0}};
+
+    if (consumed)
+        *consumed = ptr - first;
+    else if (ptr != last)
+        return {invalid_argument_t{static_cast<std::size_t>(ptr - first)}};
+    return {value};
+}
+
+/**
+ * Parse at most n numbers separated by delimiter into out, stopping at the end of input.
+ *
+ * Example:
+ *     int values[1024];
+ *     auto n = ret_exception::charconv::from_chars_bulk(input, ',', values, 1024);
+ *
+ * @return number of values parsed.
+ *         On error, the position of the exception is counted from the beginning of input,
+ *         and the values before it are already stored in out.
+ */
+template <class T>
+auto from_chars_bulk(std::string_view input, char delimiter, T *out, std::size_t n) noexcept
+    -> Ret_except<std::size_t, invalid_argument_t, out_of_range_t>
+{
+    const char *first = input.data();
+    const char *last = first + input.size();
+    const char *p = first;
+
+    std::size_t i = 0;
+    for (; i != n && p != last; ++i) {
+        const char *ptr = p;
+        auto r = impl::parse_number<T>(p, last, ptr);
+        if (r.has_exception_set()) {
+            std::size_t position = p - first;
+            if (auto *e = r.template get_error_if<out_of_range_t>())
+                return {out_of_range_t{position + e->position}};
+            return {invalid_argument_t{position + r.template get_error_if<invalid_argument_t>()->position}};
+        }
+        out[i] = r.get_return_value();
+
+        if (ptr != last && *ptr != delimiter)
+            return {invalid_argument_t{static_cast<std::size_t>(ptr - first)}};
+        p = ptr + (ptr != last);
+    }
+
+    return {i};
+}
+
+/**
+ * Format value as std::to_chars does, in the shortest representation if T is a float.
+ *
+ * @return one past the last character written, or out_of_range_t if [first, last) is too small.
+ */
+template <class T>
+auto to_chars(char *first, char *last, T value) noexcept -> Ret_except<char*, out_of_range_t>
+{
+    auto [ptr, ec] = std::to_chars(first, last, value);
+    if (ec != std::errc{})
+        return {out_of_range_t{static_cast<std::size_t>(last - first)}};
+    return {ptr};
+}
+
+/**
+ * Format values separated by delimiter.
+ *
+ * @return one past the last character written, or out_of_range_t if [first, last) is too small.
+ */
+template <class T>
+auto to_chars_bulk(char *first, char *last, const T *values, std::size_t n, char delimiter) noexcept
+    -> Ret_except<char*, out_of_range_t>
+{
+    char *p = first;
+    for (std::size_t i = 0; i != n; ++i) {
+        if (i != 0) {
+            if (p == last)
+                return {out_of_range_t{static_cast<std::size_t>(last - first)}};
+            *p++ = delimiter;
+        }
+
+        auto [ptr, ec] = std::to_chars(p, last, values[i]);
+        if (ec != std::errc{})
+            return {out_of_range_t{static_cast<std::size_t>(last - first)}};
+        p = ptr;
+    }
+    return {p};
+}
+
+/**
+ * Convert value to I by truncating towards zero.
+ *
+ * @return invalid_argument_t if value is NaN, out_of_range_t if the result does not fit in I.
+ */
+template <class I, class F>
+auto float_to_int(F value) noexcept -> from_chars_result<I>
+{
+    static_assert(std::is_integral<I>::value && std::is_floating_point<F>::value);
+
+    if (std::isnan(value))
+        return {invalid_argument_t{0}};
+
+    // Both bounds are powers of 2, thus exactly representable in F
+    constexpr F lower = std::is_signed<I>::value ? -impl::pow2<F>(std::numeric_limits<I>::digits) : F{0};
+    constexpr F upper = impl::pow2<F>(std::numeric_limits<I>::digits);
+
+    F truncated = std::trunc(value);
+    if (truncated < lower || truncated >= upper)
+        return {out_of_range_t{0}};
+    return {static_cast<I>(truncated)};
+}
+
+/**
+ * Convert value to F.
+ *
+ * @return out_of_range_t if value cannot be represented exactly by F.
+ */
+template <class F, class I>
+auto int_to_float(I value) noexcept -> Ret_except<F, out_of_range_t>
+{
+    static_assert(std::is_integral<I>::value && std::is_floating_point<F>::value);
+
+    constexpr F upper = impl::pow2<F>(std::numeric_limits<I>::digits);
+
+    F result = static_cast<F>(value);
+    if (result >= upper || static_cast<I>(result) != value)
+        return {out_of_range_t{0}};
+    return {result};
+}
+} /* namespace ret_exception::charconv */
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef  __return_exception_error_code_HPP__
+# define __return_exception_error_code_HPP__
+
+# include "ret-exception.hpp"
+
+# include <functional>
+# include <string>
+# include <system_error>
+# include <type_traits>
+# include <utility>
+
+# if __has_include(<expected>)
+#  include <expected>
+# endif
+
+namespace ret_exception {
+/**
+ * std::error_code that can be put in Ts... of Ret_except.
+ *
+ * Unlike std::system_error, no message is formatted until what() is called.
+ */
+class error_code_t {
+    int value;
+    const std::error_category *category;
+
+public:
+    error_code_t(std::error_code ec) noexcept:
+        value{ec.value()}, category{&ec.category()}
+    {}
+
+    auto code() const noexcept -> std::error_code
+    {
+        return {value, *category};
+    }
+
+    /**
+     * @return message of the error, which is valid until what() is called again on the same thread,
+     *         or the name of the category if the message cannot be formatted.
+     */
+    auto what() const noexcept -> const char*
+    {
+        thread_local std::string message;
+# if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
+        try {
+            message = category->message(value);
+        } catch (...) {
+            return category->name();
+        }
+# else
+        message = category->message(value);
+# endif
+        return message.c_str();
+    }
+};
+
+static_assert(std::is_trivially_copyable<error_code_t>::value);
+
+namespace impl {
+/**
+ * Category of exceptions of type E that do not carry an error code.
+ */
+template <class E>
+class typed_error_category: public std::error_category {
+public:
+    auto name() const noexcept -> const char* override
+    {
+        return "ret_exception";
+    }
+
+    auto message(int) const -> std::string override
+    {
+        return {type_id_v<E>.name, type_id_v<E>.name_len};
+    }
+};
+
+template <class E>
+auto typed_error_category_v() noexcept -> const std::error_category&
+{
+    static const typed_error_category<E> category;
+    return category;
+}
+
+template <class E, class = void>
+struct has_error_code_member_function: std::false_type {};
+
+template <class E>
+struct has_error_code_member_function<E, void_t<
+    typename std::enable_if<std::is_same<decltype(std::declval<const E&>().code()), std::error_code>::value ||
+                            std::is_same<decltype(std::declval<const E&>().code()), const std::error_code&>::value
+                           >::type
+>>: std::true_type {};
+
+template <class E, class = void>
+struct has_error_code_member: std::false_type {};
+
+template <class E>
+struct has_error_code_member<E, void_t<decltype(make_error_code(std::declval<const E&>().code))>>:
+    std::true_type
+{};
+} /* namespace impl */
+
+/**
+ * Map exception e to std::error_code, which is decided at compile time by its type:
+ *  - error_code_t and types with member function code() returning std::error_code,
+ *    e.g. std::system_error, return code();
+ *  - types with member code that can be passed to make_error_code, e.g. std::errc,
+ *    return make_error_code(code);
+ *  - other types are mapped to 1 in a category of their own, whose message is the name of the type.
+ */
+template <class E>
+auto make_error_code(const E &e) noexcept -> std::error_code
+{
+    if constexpr(impl::has_error_code_member_function<E>::value)
+        return e.code();
+    else if constexpr(impl::has_error_code_member<E>::value)
+        return make_error_code(e.code);
+    else
+        return {1, impl::typed_error_category_v<E>()};
+}
+
+/**
+ * @return the error code of the exception held by r, or an empty std::error_code if there is none.
+ * @post the exception held is considered handled.
+ */
+template <class Policy, template <typename...> class variant, template <class> class in_place_type_t,
+          class Ret, class ...Ts>
+auto to_error_code(Ret_except_basic_t<Policy, variant, in_place_type_t, Ret, Ts...> &r) noexcept
+    -> std::error_code
+{
+    std::error_code ec;
+    r.Catch([&](const auto &e) {
+        ec = ret_exception::make_error_code(e);
+    });
+    return ec;
+}
+
+# if __cpp_lib_expected >= 202202L
+/**
+ * @return the return value held by r, or the error code of its exception.
+ */
+template <class Policy, template <typename...> class variant, template <class> class in_place_type_t,
+          class Ret, class ...Ts>
+auto to_expected(Ret_except_basic_t<Policy, variant, in_place_type_t, Ret, Ts...> &&r)
+    -> std::expected<Ret, std::error_code>
+{
+    if (r.has_exception_set())
+        return std::unexpected{to_error_code(r)};
+
+    if constexpr(std::is_void<Ret>::value)
+        return {};
+    else
+        return {std::move(r).get_return_value()};
+}
+# endif
+
+/**
+ * @return Ret_except holding ec as error_code_t if ec is set.
+ */
+inline auto from_error_code(std::error_code ec) noexcept -> Ret_except<void, error_code_t>
+{
+    if (ec)
+        return {error_code_t{ec}};
+    return {};
+}
+
+/**
+ * Call f(args..., ec) of API that reports failures via std::error_code& ec, e.g. std::filesystem.
+ *
+ * Example:
+ *     auto size = ret_exception::invoke_with_error_code([](auto &&...args) {
+ *         return std::filesystem::file_size(args...);
+ *     }, path);
+ *
+ * @return Ret_except holding the return value of f, or error_code_t if ec is set.
+ */
+template <class F, class ...Args>
+auto invoke_with_error_code(F &&f, Args &&...args)
+    -> Ret_except<typename std::invoke_result<F, Args..., std::error_code&>::type, error_code_t>
+{
+    using R = typename std::invoke_result<F, Args..., std::error_code&>::type;
+
+    std::error_code ec;
+    if constexpr(std::is_void<R>::value) {
+        std::invoke(std::forward<F>(f), std::forward<Args>(args)..., ec);
+        if (ec)
+            return {error_code_t{ec}};
+        return {};
+    } else {
+        R ret = std::invoke(std::forward<F>(f), std::forward<Args>(args)..., ec);
+        if (ec)
+            return {error_code_t{ec}};
+        return {std::move(ret)};
+    }
+}
+} /* namespace ret_exception */
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef  __return_exception_io_HPP__
+# define __return_exception_io_HPP__
+
+# include "ret-exception.hpp"
+
+# include <iterator>
+# include <string_view>
+# include <system_error>
+# include <type_traits>
+# include <utility>
+
+# include <cerrno>
+# include <cstddef>
+# include <cstring>
+
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+# include <sys/uio.h>
+# include <unistd.h>
+
+/**
+ * Thin wrappers of syscalls returning Ret_except instead of setting errno.
+ *
+ * Buffers are always owned by the caller, thus no copy is made.
+ */
+namespace ret_exception::io {
+/**
+ * errno set by the syscall.
+ */
+struct sys_error {
+    std::errc code;
+
+    auto what() const noexcept -> const char*
+    {
+        return std::strerror(static_cast<int>(code));
+    }
+};
+
+/**
+ * errno set by the syscall, as its own type so that it can be handled separately.
+ */
+template <std::errc errc>
+struct errc_error {
+    static constexpr std::errc code = errc;
+
+    auto what() const noexcept -> const char*
+    {
+        return std::strerror(static_cast<int>(code));
+    }
+};
+
+using interrupted = errc_error<std::errc::interrupted>;
+using would_block = errc_error<std::errc::operation_would_block>;
+
+/**
+ * Compile-time flags selecting how EINTR and EAGAIN are handled.
+ */
+enum flags: unsigned {
+    /**
+     * Retry on EINTR and report EAGAIN as sys_error.
+     */
+    default_flags = 0,
+    /**
+     * Report EINTR as interrupted instead of retrying.
+     */
+    report_eintr = 1 << 0,
+    /**
+     * Report EAGAIN as would_block instead of sys_error.
+     */
+    report_eagain = 1 << 1,
+};
+
+/**
+ * Ret_except<Ret, [interrupted], [would_block], sys_error>, where interrupted and would_block
+ * are only present if requested by flags.
+ */
+template <class Ret, unsigned flags>
+using io_result = glue_ret_except_t<
+    glue_ret_except_t<
+        typename std::conditional<(flags & report_eintr) != 0,
+                                  Ret_except<Ret, interrupted>, Ret_except<Ret>>::type,
+        typename std::conditional<(flags & report_eagain) != 0,
+                                  Ret_except<Ret, would_block>, Ret_except<Ret>>::type
+    >,
+    Ret_except<Ret, sys_error>
+>;
+
+namespace impl {
+template <unsigned flags, class Ret>
+auto from_errno(int err) noexcept -> io_result<Ret, flags>
+{
+    if constexpr((flags & report_eintr) != 0)
+        if (err == EINTR)
+            return {interrupted{}};
+    if constexpr((flags & report_eagain) != 0)
+        if (err == EAGAIN || err == EWOULDBLOCK)
+            return {would_block{}};
+    return {sys_error{static_cast<std::errc>(err)}};
+}
+
+/**
+ * Call f until it does not fail with EINTR, unless flags contains report_eintr.
+ */
+template <unsigned flags, class Ret, class F>
+auto syscall(F &&f) noexcept -> io_result<Ret, flags>
+{
+    for (;;) {
+        auto ret = f();
+        if (ret != -1)
+            return {static_cast<Ret>(ret)};
+
+        int err = errno;
+        if constexpr((flags & report_eintr) == 0)
+            if (err == EINTR)
+                continue;
+        return from_errno<flags, Ret>(err);
+    }
+}
+
+template <class Buffer>
+using value_type_t = typename std::remove_reference<decltype(*std::data(std::declval<Buffer&>()))>::type;
+} /* namespace impl */
+
+template <unsigned flags = default_flags>
+auto read(int fd, void *buf, std::size_t len) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::read(fd, buf, len); });
+}
+
+/**
+ * @param buf contiguous container, e.g. std::array or std::vector, that supports std::data and std::size
+ * @return number of bytes read.
+ */
+template <unsigned flags = default_flags, class Buffer>
+auto read(int fd, Buffer &buf) noexcept -> io_result<std::size_t, flags>
+{
+    static_assert(!std::is_const<impl::value_type_t<Buffer>>::value, "buf must be writable");
+    return read<flags>(fd, std::data(buf), std::size(buf) * sizeof(impl::value_type_t<Buffer>));
+}
+
+template <unsigned flags = default_flags>
+auto write(int fd, const void *buf, std::size_t len) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::write(fd, buf, len); });
+}
+
+/**
+ * @param buf contiguous container, e.g. std::string_view or std::vector, that supports std::data and std::size
+ * @return number of bytes written.
+ */
+template <unsigned flags = default_flags, class Buffer>
+auto write(int fd, const Buffer &buf) noexcept -> io_result<std::size_t, flags>
+{
+    return write<flags>(fd, std::data(buf), std::size(buf) * sizeof(impl::value_type_t<const Buffer>));
+}
+
+template <unsigned flags = default_flags>
+auto pread(int fd, void *buf, std::size_t len, off_t offset) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::pread(fd, buf, len, offset); });
+}
+
+template <unsigned flags = default_flags>
+auto pwrite(int fd, const void *buf, std::size_t len, off_t offset) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::pwrite(fd, buf, len, offset); });
+}
+
+template <unsigned flags = default_flags>
+auto readv(int fd, const struct iovec *iov, int iovcnt) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::readv(fd, iov, iovcnt); });
+}
+
+template <unsigned flags = default_flags>
+auto writev(int fd, const struct iovec *iov, int iovcnt) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::writev(fd, iov, iovcnt); });
+}
+
+template <unsigned flags = default_flags>
+auto recv(int sockfd, void *buf, std::size_t len, int mflags = 0) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::recv(sockfd, buf, len, mflags); });
+}
+
+template <unsigned flags = default_flags>
+auto send(int sockfd, const void *buf, std::size_t len, int mflags = 0) noexcept -> io_result<std::size_t, flags>
+{
+    return impl::syscall<flags, std::size_t>([&] { return ::send(sockfd, buf, len, mflags); });
+}
+
+/**
+ * @return the fd opened, which is owned by the caller.
+ */
+template <unsigned flags = default_flags>
+auto open(const char *pathname, int oflags, mode_t mode = 0) noexcept -> io_result<int, flags>
+{
+    return impl::syscall<flags, int>([&] { return ::open(pathname, oflags, mode); });
+}
+
+template <unsigned flags = default_flags>
+auto close(int fd) noexcept -> io_result<void, flags>
+{
+    // fd is always closed on Linux even if EINTR is returned, thus it must not be retried
+    if (::close(fd) == -1 && errno != EINTR)
+        return impl::from_errno<flags, void>(errno);
+    return {};
+}
+
+/**
+ * Memory mapped by mmap, unmapped on destruction.
+ */
+class mapping {
+    void *addr = nullptr;
+    std::size_t len = 0;
+
+public:
+    mapping() = default;
+
+    mapping(void *addr, std::size_t len) noexcept:
+        addr{addr}, len{len}
+    {}
+
+    mapping(mapping &&other) noexcept:
+        addr{std::exchange(other.addr, nullptr)}, len{std::exchange(other.len, 0)}
+    {}
+
+    mapping& operator = (mapping &&other) noexcept
+    {
+        std::swap(addr, other.addr);
+        std::swap(len, other.len);
+        return *this;
+    }
+
+    auto data() const noexcept -> void*
+    {
+        return addr;
+    }
+    auto size() const noexcept -> std::size_t
+    {
+        return len;
+    }
+
+    auto as_string_view() const noexcept -> std::string_view
+    {
+        return {static_cast<const char*>(addr), len};
+    }
+
+    ~mapping()
+    {
+        if (addr)
+            ::munmap(addr, len);
+    }
+};
+
+template <unsigned flags = default_flags>
+auto mmap(void *addr, std::size_t len, int prot, int mflags, int fd, off_t offset) noexcept
+    -> io_result<mapping, flags>
+{
+    void *ret = ::mmap(addr, len, prot, mflags, fd, offset);
+    if (ret == MAP_FAILED)
+        return impl::from_errno<flags, mapping>(errno);
+    return {std::in_place_type<mapping>, ret, len};
+}
+
+/**
+ * Map the whole file opened as fd for reading.
+ *
+ * Empty file is mapped to an empty mapping, since mmap does not accept 0 length.
+ * The file offset of fd is left untouched.
+ */
+template <unsigned flags = default_flags>
+auto mmap_file(int fd) noexcept -> io_result<mapping, flags>
+{
+    struct stat st;
+    if (::fstat(fd, &st) == -1)
+        return impl::from_errno<flags, mapping>(errno);
+
+    off_t len = st.st_size;
+    if (len == 0)
+        return {std::in_place_type<mapping>};
+    return mmap<flags>(nullptr, static_cast<std::size_t>(len), PROT_READ, MAP_PRIVATE, fd, 0);
+}
+} /* namespace ret_exception::io */
+
+#endif
@@ -0,0 +1,331 @@
+#ifndef  __return_exception_memoize_HPP__
+# define __return_exception_memoize_HPP__
+
+# include "ret-exception.hpp"
+# include "ret-exception-shared.hpp"
+
+# include <chrono>
+# include <condition_variable>
+# include <functional>
+# include <memory>
+# include <mutex>
+# include <tuple>
+# include <type_traits>
+# include <unordered_map>
+# include <utility>
+# include <vector>
+
+# include <cstddef>
+
+namespace ret_exception {
+struct memoize_options {
+    /**
+     * Maximum number of results cached, evicted by CLOCK when exceeded.
+     */
+    std::size_t capacity = 4096;
+
+    /**
+     * Number of independently locked shards.
+     */
+    std::size_t shards = 16;
+
+    /**
+     * If false, only the concurrent callers waiting on the computation get the exception,
+     * later callers would call the function again.
+     */
+    bool cache_errors = true;
+
+    /**
+     * How long an exception is cached if cache_errors is true.
+     */
+    std::chrono::steady_clock::duration error_ttl = std::chrono::seconds{1};
+};
+
+namespace impl {
+template <class F>
+struct callable_traits: callable_traits<decltype(&F::operator())> {};
+
+template <class R, class ...Args>
+struct callable_traits<R (*)(Args...)> {
+    using result_type = R;
+    using key_type = std::tuple<typename std::decay<Args>::type...>;
+};
+template <class R, class ...Args>
+struct callable_traits<R (*)(Args...) noexcept>: callable_traits<R (*)(Args...)> {};
+
+template <class R, class C, class ...Args>
+struct callable_traits<R (C::*)(Args...)>: callable_traits<R (*)(Args...)> {};
+template <class R, class C, class ...Args>
+struct callable_traits<R (C::*)(Args...) const>: callable_traits<R (*)(Args...)> {};
+template <class R, class C, class ...Args>
+struct callable_traits<R (C::*)(Args...) noexcept>: callable_traits<R (*)(Args...)> {};
+template <class R, class C, class ...Args>
+struct callable_traits<R (C::*)(Args...) const noexcept>: callable_traits<R (*)(Args...)> {};
+
+template <class Ret_except_t>
+struct shared_result_of;
+
+template <class Ret, class ...Ts>
+struct shared_result_of<Ret_except<Ret, Ts...>> {
+    using type = shared_result<Ret, Ts...>;
+};
+
+struct tuple_hash {
+    template <class ...Ts>
+    std::size_t operator () (const std::tuple<Ts...> &key) const
+    {
+        return std::apply([](const auto &...vals) {
+            std::size_t seed = 0;
+            ((seed ^= std::hash<typename std::decay<decltype(vals)>::type>{}(vals) +
+                      0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)), ...);
+            return seed;
+        }, key);
+    }
+};
+} /* namespace impl */
+
+/**
+ * Wraps a function returning Ret_except in a concurrent cache keyed on its arguments.
+ *
+ * Concurrent calls with the same arguments only call the function once and share its result,
+ * while the others block until it is published.
+ * Every caller gets its own copy of the result, thus its own exception to handle.
+ *
+ * The exception should be returned via Ret_except: if the function throws, nothing is cached,
+ * the exception propagates to the caller calling it and the callers waiting on it call
+ * the function again.
+ */
+template <class F>
+class memoized {
+    using traits = impl::callable_traits<F>;
+
+public:
+    using result_type = typename traits::result_type;
+    using key_type = typename traits::key_type;
+
+private:
+    using cell_t = typename impl::shared_result_of<result_type>::type;
+    using clock = std::chrono::steady_clock;
+
+    struct entry_t {
+        key_type key;
+        std::shared_ptr<cell_t> cell;
+        clock::time_point expiry;
+        bool is_referenced;
+    };
+
+    struct shard_t {
+        std::mutex mutex;
+        /**
+         * Notified when a cell in this shard is published or abandoned.
+         */
+        std::condition_variable published;
+        std::unordered_map<key_type, std::size_t, impl::tuple_hash> index;
+        std::vector<entry_t> slots;
+        std::size_t hand = 0;
+    };
+
+    F f;
+    memoize_options options;
+    std::size_t shard_capacity;
+    std::unique_ptr<shard_t[]> shards;
+
+    /**
+     * @pre shard.mutex is locked
+     */
+    void insert_locked(shard_t &shard, const key_type &key, std::shared_ptr<cell_t> cell)
+    {
+        entry_t entry{key, std::move(cell), clock::time_point::max(), true};
+
+        if (shard.slots.size() < shard_capacity) {
+            shard.index.emplace(key, shard.slots.size());
+            shard.slots.push_back(std::move(entry));
+            return;
+        }
+
+        // CLOCK: give referenced entries a second chance and never evict the ones
+        // still being computed, since they are the key to single-flight.
+        //
+        // If all of them are being computed, exceed the capacity by at most the
+        // number of threads computing.
+        for (std::size_t i = 0; ; ++i, shard.hand = (shard.hand + 1) % shard.slots.size()) {
+            if (i == 2 * shard.slots.size()) {
+                shard.index.emplace(key, shard.slots.size());
+                shard.slots.push_back(std::move(entry));
+                return;
+            }
+
+            entry_t &victim = shard.slots[shard.hand];
+            if (!victim.cell->is_ready())
+                continue;
+            if (!victim.is_referenced)
+                break;
+            victim.is_referenced = false;
+        }
+
+        shard.index.erase(shard.slots[shard.hand].key);
+        shard.index.emplace(key, shard.hand);
+        shard.slots[shard.hand] = std::move(entry);
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+
+    /**
+     * @pre shard.mutex is locked
+     */
+    void erase_locked(shard_t &shard, std::size_t slot)
+    {
+        shard.index.erase(shard.slots[slot].key);
+        if (slot != shard.slots.size() - 1) {
+            shard.slots[slot] = std::move(shard.slots.back());
+            shard.index[shard.slots[slot].key] = slot;
+        }
+        shard.slots.pop_back();
+
+        if (shard.hand >= shard.slots.size())
+            shard.hand = 0;
+    }
+
+    /**
+     * @pre shard.mutex is locked
+     * @return true if cell is still the one cached for key.
+     */
+    static bool is_cached_locked(shard_t &shard, const key_type &key, const std::shared_ptr<cell_t> &cell)
+    {
+        auto it = shard.index.find(key);
+        return it != shard.index.end() && shard.slots[it->second].cell == cell;
+    }
+
+    /**
+     * Update the entry of key after its cell is published or abandoned since f throws,
+     * then wake up the callers waiting on it.
+     */
+    void on_published(shard_t &shard, const key_type &key, const std::shared_ptr<cell_t> &cell)
+    {
+        {
+            std::lock_guard<std::mutex> guard{shard.mutex};
+
+            if ((!cell->is_ready() || cell->has_exception_set()) && is_cached_locked(shard, key, cell)) {
+                std::size_t slot = shard.index.find(key)->second;
+
+                if (cell->is_ready() && options.cache_errors)
+                    shard.slots[slot].expiry = clock::now() + options.error_ttl;
+                else
+                    erase_locked(shard, slot);
+            }
+        }
+        shard.published.notify_all();
+    }
+
+    /**
+     * Calls on_published even if f throws.
+     */
+    struct publish_guard {
+        memoized &self;
+        shard_t &shard;
+        const key_type &key;
+        const std::shared_ptr<cell_t> &cell;
+
+        ~publish_guard()
+        {
+            self.on_published(shard, key, cell);
+        }
+    };
+
+    /**
+     * Block until cell is published.
+     *
+     * @return false if cell is abandoned.
+     */
+    static bool wait(shard_t &shard, const key_type &key, const std::shared_ptr<cell_t> &cell)
+    {
+        if (cell->is_ready())
+            return true;
+
+        std::unique_lock<std::mutex> lock{shard.mutex};
+        shard.published.wait(lock, [&] {
+            return cell->is_ready() || !is_cached_locked(shard, key, cell);
+        });
+        return cell->is_ready();
+    }
+
+public:
+    memoized(F f, memoize_options options):
+        f(std::move(f)),
+        options(options),
+        shard_capacity{options.capacity / (options.shards ? options.shards : 1)},
+        shards{new shard_t[options.shards ? options.shards : 1]}
+    {
+        if (this->options.shards == 0)
+            this->options.shards = 1;
+        if (shard_capacity == 0)
+            shard_capacity = 1;
+
+        for (std::size_t i = 0; i != this->options.shards; ++i)
+            shards[i].slots.reserve(shard_capacity);
+    }
+
+    template <class ...Args>
+    auto operator () (Args &&...args) -> result_type
+    {
+        key_type key{std::forward<Args>(args)...};
+        shard_t &shard = shards[impl::tuple_hash{}(key) % options.shards];
+
+        for (;;) {
+            std::shared_ptr<cell_t> cell;
+            bool is_owner = false;
+            {
+                std::lock_guard<std::mutex> guard{shard.mutex};
+
+                auto it = shard.index.find(key);
+                if (it != shard.index.end()) {
+                    entry_t &entry = shard.slots[it->second];
+
+                    if (entry.cell->has_exception_set() && clock::now() >= entry.expiry)
+                        erase_locked(shard, it->second);
+                    else {
+                        entry.is_referenced = true;
+                        cell = entry.cell;
+                    }
+                }
+
+                if (!cell) {
+                    cell = std::make_shared<cell_t>();
+                    is_owner = true;
+                    insert_locked(shard, key, cell);
+                }
+            }
+
+            if (is_owner) {
+                publish_guard guard{*this, shard, key, cell};
+                (void) cell->publish(std::apply(f, static_cast<const key_type&>(key)));
+                return cell->to_ret_except();
+            }
+
+            // Call f again if the caller computing it throws
+            if (wait(shard, key, cell))
+                return cell->to_ret_except();
+        }
+    }
+};
+
+/**
+ * Example:
+ *     auto lookup(std::string key) -> Ret_except<Record, NotFound, Timeout>;
+ *
+ *     ret_exception::memoize_options options;
+ *     options.cache_errors = false;
+ *
+ *     auto cached_lookup = ret_exception::memoize(lookup, options);
+ *     cached_lookup("key").Catch(...);
+ *
+ * @param f must return Ret_except and take arguments that can be hashed by std::hash
+ *          and compared by operator ==.
+ */
+template <class F>
+auto memoize(F f, memoize_options options = {}) -> memoized<F>
+{
+    return {std::move(f), options};
+}
+} /* namespace ret_exception */
+
+#endif
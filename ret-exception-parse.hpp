@@ -0,0 +1,317 @@
+#ifndef  __return_exception_parse_HPP__
+# define __return_exception_parse_HPP__
+
+# include "ret-exception.hpp"
+# include "ret-exception-charconv.hpp"
+
+# include <functional>
+# include <memory>
+# include <string_view>
+# include <type_traits>
+# include <utility>
+
+# include <cstddef>
+# include <cstring>
+
+/**
+ * Parsing over windows of a buffer, e.g. a file mapped by mmap, without copying the input.
+ *
+ * Every stage takes a cursor and returns Ret_except, whose exceptions carry the offset
+ * of the byte where the error is found, counted from the beginning of the whole input.
+ */
+namespace ret_exception::parse {
+struct syntax_error {
+    std::size_t offset;
+    char expected;
+
+    auto what() const noexcept -> const char*
+    {
+        return "Unexpected character";
+    }
+};
+
+struct invalid_number {
+    std::size_t offset;
+
+    auto what() const noexcept -> const char*
+    {
+        return "Invalid number";
+    }
+};
+
+struct number_out_of_range {
+    std::size_t offset;
+
+    auto what() const noexcept -> const char*
+    {
+        return "Number out of range";
+    }
+};
+
+/**
+ * A window of the input and the position of the next byte to parse in it.
+ */
+class cursor {
+    std::string_view window;
+    std::size_t pos = 0;
+    std::size_t base;
+
+public:
+    /**
+     * @param base offset of window.data() from the beginning of the whole input.
+     */
+    constexpr cursor(std::string_view window, std::size_t base = 0) noexcept:
+        window{window}, base{base}
+    {}
+
+    /**
+     * @return the part of the window not yet parsed.
+     */
+    constexpr auto rest() const noexcept -> std::string_view
+    {
+        return {window.data() + pos, window.size() - pos};
+    }
+
+    /**
+     * @return offset of the next byte from the beginning of the whole input.
+     */
+    constexpr auto offset() const noexcept -> std::size_t
+    {
+        return base + pos;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return pos == window.size();
+    }
+
+    /**
+     * @pre !empty()
+     */
+    constexpr char peek() const noexcept
+    {
+        return window[pos];
+    }
+
+    /**
+     * @pre n <= rest().size()
+     */
+    constexpr void advance(std::size_t n) noexcept
+    {
+        pos += n;
+    }
+
+    /**
+     * Skip c if it is the next byte.
+     */
+    constexpr bool consume(char c) noexcept
+    {
+        if (empty() || peek() != c)
+            return false;
+        ++pos;
+        return true;
+    }
+
+    /**
+     * @return bytes up to delimiter or the end of the window, whichever comes first.
+     * @post the delimiter is skipped.
+     */
+    auto take_until(char delimiter) noexcept -> std::string_view
+    {
+        std::string_view r = rest();
+        const void *p = std::memchr(r.data(), delimiter, r.size());
+
+        std::size_t len = p ? static_cast<const char*>(p) - r.data() : r.size();
+        pos += len + (p != nullptr);
+        return r.substr(0, len);
+    }
+};
+
+template <class T>
+using parse_number_result = Ret_except<T, invalid_number, number_out_of_range>;
+
+namespace impl {
+template <class T>
+auto parse_number(cursor &c) noexcept -> parse_number_result<T>
+{
+    std::string_view r = c.rest();
+    const char *ptr = r.data();
+
+    auto n = charconv::impl::parse_number<T>(r.data(), r.data() + r.size(), ptr);
+    if (n.has_exception_set()) {
+        if (n.template get_error_if<charconv::out_of_range_t>())
+            return {number_out_of_range{c.offset()}};
+        (void) n.template get_error_if<charconv::invalid_argument_t>();
+        return {invalid_number{c.offset()}};
+    }
+
+    c.advance(ptr - r.data());
+    return {n.get_return_value()};
+}
+} /* namespace impl */
+
+/**
+ * Parse an integer in decimal with an optional '-' if T is signed, by charconv::from_chars.
+ *
+ * @post the cursor is only advanced on success.
+ */
+template <class T>
+auto parse_int(cursor &c) noexcept -> parse_number_result<T>
+{
+    static_assert(std::is_integral<T>::value, "T must be an integer");
+    return impl::parse_number<T>(c);
+}
+
+/**
+ * Parse a float in the general format, by charconv::from_chars.
+ *
+ * @post the cursor is only advanced on success.
+ */
+template <class T = double>
+auto parse_float(cursor &c) noexcept -> parse_number_result<T>
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a float");
+    return impl::parse_number<T>(c);
+}
+
+/**
+ * @return syntax_error if the next byte is not c.
+ * @post c is skipped if it is the next byte.
+ */
+inline auto expect(cursor &cur, char c) noexcept -> Ret_except<void, syntax_error>
+{
+    if (!cur.consume(c))
+        return {syntax_error{cur.offset(), c}};
+    return {};
+}
+
+namespace impl {
+template <class F>
+using stage_result_t = glue_ret_except_t<Ret_except<void>, typename std::invoke_result<F&, cursor&>::type>;
+
+/**
+ * Call f on every record in window terminated by delimiter.
+ *
+ * @param consumed set to the number of bytes of the records parsed, including their delimiters.
+ */
+template <class Result, class F>
+auto parse_records(std::string_view window, std::size_t base, char delimiter, F &f,
+                   std::size_t &consumed) -> Result
+{
+    const char *begin = window.data();
+    const char *end = begin + window.size();
+
+    for (const char *p = begin; p != end; ) {
+        const char *q = static_cast<const char*>(std::memchr(p, delimiter, end - p));
+        if (!q)
+            break;
+
+        cursor c{{p, static_cast<std::size_t>(q - p)}, base + (p - begin)};
+        auto r = std::invoke(f, c);
+        if (r.has_exception_set())
+            return {std::move(r)};
+
+        p = q + 1;
+        consumed = p - begin;
+    }
+
+    return {};
+}
+} /* namespace impl */
+
+/**
+ * Call f on every record of input terminated by delimiter, the last of which might be
+ * unterminated, until f returns an exception.
+ *
+ * Example:
+ *     auto file = ret_exception::io::mmap_file(fd);
+ *
+ *     ret_exception::parse::for_each_record(file.get_return_value().as_string_view(), '\n',
+ *         [&](ret_exception::parse::cursor &c) {
+ *             auto n = ret_exception::parse::parse_int<int>(c);
+ *             ...
+ *         }).Catch(...);
+ *
+ * @param f takes cursor& over the record without the delimiter and returns Ret_except.
+ * @return Ret_except<void, exceptions of f...>
+ */
+template <class F>
+auto for_each_record(std::string_view input, char delimiter, F &&f) -> impl::stage_result_t<F>
+{
+    using Result = impl::stage_result_t<F>;
+
+    std::size_t consumed = 0;
+    auto r = impl::parse_records<Result>(input, 0, delimiter, f, consumed);
+    if (r.has_exception_set() || consumed == input.size())
+        return r;
+
+    cursor c{input.substr(consumed), consumed};
+    return {std::invoke(f, c)};
+}
+
+/**
+ * Same as for_each_record, but the input is read by chunks into a buffer, which grows only
+ * if a record cannot fit in it.
+ *
+ * Example:
+ *     ret_exception::parse::for_each_record_chunked([&](char *buf, std::size_t len) {
+ *         return ret_exception::io::read(fd, buf, len);
+ *     }, '\n', f).Catch(...);
+ *
+ * @param read takes (char *buf, std::size_t len) and returns Ret_except<std::size_t, ...>
+ *             holding the number of bytes read into buf, 0 on EOF.
+ * @return Ret_except<void, exceptions of f..., exceptions of read...>
+ */
+template <class Reader, class F>
+auto for_each_record_chunked(Reader &&read, char delimiter, F &&f, std::size_t chunk_size = 64 * 1024)
+    -> glue_ret_except_t<
+        impl::stage_result_t<F>,
+        glue_ret_except_t<Ret_except<void>, typename std::invoke_result<Reader&, char*, std::size_t>::type>
+    >
+{
+    using Result = glue_ret_except_t<
+        impl::stage_result_t<F>,
+        glue_ret_except_t<Ret_except<void>, typename std::invoke_result<Reader&, char*, std::size_t>::type>
+    >;
+
+    std::size_t capacity = chunk_size ? chunk_size : 1;
+    std::unique_ptr<char[]> buffer{new char[capacity]};
+    std::size_t len = 0;
+    std::size_t base = 0;
+
+    for (;;) {
+        if (len == capacity) {
+            std::unique_ptr<char[]> bigger{new char[capacity * 2]};
+            std::memcpy(bigger.get(), buffer.get(), len);
+            buffer = std::move(bigger);
+            capacity *= 2;
+        }
+
+        auto n = std::invoke(read, buffer.get() + len, capacity - len);
+        if (n.has_exception_set())
+            return {std::move(n)};
+
+        std::size_t nread = n.get_return_value();
+        if (nread == 0) {
+            if (len == 0)
+                return {};
+
+            cursor c{{buffer.get(), len}, base};
+            return {std::invoke(f, c)};
+        }
+
+        len += nread;
+
+        std::size_t consumed = 0;
+        auto r = impl::parse_records<Result>({buffer.get(), len}, base, delimiter, f, consumed);
+        if (r.has_exception_set())
+            return r;
+
+        std::memmove(buffer.get(), buffer.get() + consumed, len - consumed);
+        len -= consumed;
+        base += consumed;
+    }
+}
+} /* namespace ret_exception::parse */
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef  __return_exception_retry_HPP__
+# define __return_exception_retry_HPP__
+
+# include "ret-exception.hpp"
+
+# include <chrono>
+# include <functional>
+# include <random>
+# include <thread>
+# include <type_traits>
+# include <utility>
+
+# include <cstdint>
+
+namespace ret_exception {
+struct retry_policy {
+    /**
+     * Maximum number of calls, including the first one.
+     */
+    unsigned max_attempts = 3;
+
+    /**
+     * Backoff before the second call, multiplied by multiplier after every call
+     * and capped by max_backoff.
+     */
+    std::chrono::nanoseconds initial_backoff = std::chrono::milliseconds{1};
+    double multiplier = 2;
+    std::chrono::nanoseconds max_backoff = std::chrono::seconds{1};
+
+    /**
+     * The backoff actually slept is picked uniformly from [backoff * (1 - jitter), backoff].
+     */
+    double jitter = 0.5;
+
+    /**
+     * Time budget counted from the first call: no retry is done if the backoff
+     * would exceed it.
+     */
+    std::chrono::nanoseconds deadline = std::chrono::nanoseconds::max();
+};
+
+namespace impl {
+inline auto jittered(std::chrono::nanoseconds backoff, double jitter) -> std::chrono::nanoseconds
+{
+    if (jitter <= 0 || backoff.count() <= 0)
+        return backoff;
+
+    thread_local std::minstd_rand rng{static_cast<std::uint_fast32_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count() ^
+        std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+
+    std::uniform_real_distribution<double> dist{1 - jitter, 1};
+    return std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(backoff.count() * dist(rng))};
+}
+} /* namespace impl */
+
+/**
+ * Call f until it returns a value or an exception not in RetryableErrors...,
+ * or until policy gives up.
+ *
+ * Whether to retry is decided only by testing whether the exception is one of
+ * RetryableErrors..., thus no visit is done.
+ *
+ * Exceptions of the calls retried are handled by retry, the last one is returned.
+ *
+ * Example:
+ *     auto lock() -> Ret_except<void, WouldBlock, PermissionDenied>;
+ *
+ *     ret_exception::retry<WouldBlock>({}, lock).Catch(...);
+ *
+ * @param f takes no argument and returns Ret_except.
+ */
+template <class ...RetryableErrors, class F>
+auto retry(const retry_policy &policy, F &&f) -> typename std::invoke_result<F&>::type
+{
+    static_assert(sizeof...(RetryableErrors) != 0, "At least one exception to retry must be specified");
+
+    auto start = std::chrono::steady_clock::now();
+    auto backoff = policy.initial_backoff;
+
+    for (unsigned attempt = 1; ; ++attempt) {
+        auto r = std::invoke(f);
+
+        if (!r.has_exception_set() || !(r.template has_exception_type<RetryableErrors>() || ...))
+            return r;
+        if (attempt >= policy.max_attempts)
+            return r;
+
+        auto sleep = impl::jittered(backoff, policy.jitter);
+        if (std::chrono::steady_clock::now() + sleep - start > policy.deadline)
+            return r;
+
+        // Mark the exception as handled
+        (void) (r.template get_error_if<RetryableErrors>() || ...);
+
+        if (sleep.count() > 0)
+            std::this_thread::sleep_for(sleep);
+
+        if (backoff < policy.max_backoff)
+            backoff = std::chrono::duration_cast<std::chrono::nanoseconds>(backoff * policy.multiplier);
+        if (backoff > policy.max_backoff)
+            backoff = policy.max_backoff;
+    }
+}
+} /* namespace ret_exception */
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef  __return_exception_shared_HPP__
+# define __return_exception_shared_HPP__
+
+# include "ret-exception.hpp"
+
+# include <atomic>
+# include <thread>
+# include <tuple>
+# include <utility>
+# include <type_traits>
+# include <variant>
+
+namespace ret_exception {
+/**
+ * A write-once cell holding the result of a function returning Ret_except<Ret, Ts...>,
+ * which can be read by many threads.
+ *
+ * The result is published with release ordering and read with acquire ordering,
+ * so reads are lock-free and wait-free.
+ *
+ * The exception stored is considered handled once any reader handles it.
+ * If it is published but not handled by anyone when the cell is destroyed,
+ * it would be thrown in destructor, just like Ret_except.
+ */
+template <class Ret, class ...Ts>
+class shared_result {
+    using monostate = impl::monostate;
+
+    enum state_t: unsigned char {
+        empty,
+        writing,
+        ready,
+    };
+
+    std::atomic<unsigned char> state{empty};
+    mutable std::atomic<bool> is_exception_handled{false};
+
+    /**
+     * If Ret == void, monostate in a ready cell means the function returned successfully.
+     */
+    using variant_t = typename std::conditional<std::is_void<Ret>::value,
+                                                std::variant<monostate, Ts...>,
+                                                std::variant<monostate, Ret, Ts...>>::type;
+    variant_t v;
+
+    static constexpr std::size_t ret_index = std::is_void<Ret>::value ? 0 : 1;
+
+    void mark_handled() const noexcept
+    {
+        // Avoid writing to the cache line shared by all readers if possible
+        if (!is_exception_handled.load(std::memory_order_relaxed))
+            is_exception_handled.store(true, std::memory_order_relaxed);
+    }
+
+public:
+    using Ret_except_t = Ret_except<Ret, Ts...>;
+
+    shared_result() = default;
+
+    shared_result(const shared_result&) = delete;
+    shared_result& operator = (const shared_result&) = delete;
+
+    /**
+     * Publish the result held by r, can only succeed once.
+     *
+     * @return false if the result is already published by another call, in which case
+     *         r is left untouched.
+     * @post if true is returned, r has no unhandled exception.
+     */
+    bool publish(Ret_except_t &&r)
+    {
+        unsigned char expected = empty;
+        if (!state.compare_exchange_strong(expected, writing, std::memory_order_relaxed))
+            return false;
+
+        if (r.has_exception_set())
+            std::move(r).Catch([this](auto &&e) {
+                using Exception_t = typename std::decay<decltype(e)>::type;
+                v.template emplace<Exception_t>(std::move(e));
+            });
+        else {
+            if constexpr(!std::is_void<Ret>::value)
+                v.template emplace<Ret>(std::move(r).get_return_value());
+        }
+
+        state.store(ready, std::memory_order_release);
+        return true;
+    }
+
+    bool is_ready() const noexcept
+    {
+        return state.load(std::memory_order_acquire) == ready;
+    }
+
+    /**
+     * Spin until the result is published.
+     */
+    void wait() const noexcept
+    {
+        while (!is_ready())
+            std::this_thread::yield();
+    }
+
+    /**
+     * @return false if the result is not published yet.
+     */
+    bool has_exception_set() const noexcept
+    {
+        return is_ready() && v.index() != ret_index;
+    }
+    bool has_exception_handled() const noexcept
+    {
+        return is_exception_handled.load(std::memory_order_relaxed);
+    }
+
+    template <class E>
+    bool has_exception_type() const noexcept
+    {
+        return is_ready() && std::holds_alternative<E>(v);
+    }
+
+    /**
+     * @return nullptr if the result is not published yet or it is an exception.
+     */
+    template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
+    auto get_if() const noexcept -> const T*
+    {
+        if (!is_ready())
+            return nullptr;
+        return std::get_if<Ret>(&v);
+    }
+
+    /**
+     * @return nullptr if the result is not published yet or it is not an exception of type E.
+     * @post if the return value is not nullptr, has_exception_handled() == true
+     */
+    template <class E>
+    auto get_error_if() const noexcept -> const E*
+    {
+        if (!is_ready())
+            return nullptr;
+
+        const E *e = std::get_if<E>(&v);
+        if (e)
+            mark_handled();
+        return e;
+    }
+
+    /**
+     * Handle the exception with the first handler in fs... that can take a const reference to it,
+     * following the semantics of Ret_except::Catch(fs...).
+     *
+     * Does nothing if the result is not published yet or it is not an exception.
+     */
+    template <class ...Fs>
+    auto Catch(Fs &&...fs) const -> const shared_result&
+    {
+        if (has_exception_set())
+            std::visit([&, this](const auto &e) {
+                using Exception_t = typename std::decay<decltype(e)>::type;
+
+                if constexpr(!std::is_same<Exception_t, monostate>::value &&
+                             !std::is_same<Exception_t, Ret>::value) {
+                    constexpr std::size_t i = impl::first_handler_index<const Exception_t&, Fs...>();
+
+                    if constexpr(i != sizeof...(Fs)) {
+                        mark_handled();
+                        std::invoke(std::get<i>(std::forward_as_tuple(std::forward<Fs>(fs)...)), e);
+                    }
+                }
+            }, v);
+
+        return *this;
+    }
+
+    /**
+     * Copy the result into a new Ret_except, which takes over the responsibility of
+     * handling the exception.
+     *
+     * @pre is_ready()
+     * @post if an exception is published, has_exception_handled() == true
+     */
+    auto to_ret_except() const -> Ret_except_t
+    {
+        return std::visit([this](const auto &val) -> Ret_except_t {
+            using T = typename std::decay<decltype(val)>::type;
+
+            if constexpr(std::is_same<T, monostate>::value)
+                return {};
+            else {
+                if constexpr(!std::is_same<T, Ret>::value)
+                    mark_handled();
+                return {std::in_place_type<T>, val};
+            }
+        }, v);
+    }
+
+    /**
+     * If the exception published is not handled by anyone, this would cause
+     * the program to terminate.
+     */
+    ~shared_result() noexcept(false)
+    {
+        if (state.load(std::memory_order_acquire) != ready || v.index() == ret_index ||
+            has_exception_handled())
+            return;
+
+        std::visit([](auto &&e) {
+            using Exception_t = typename std::decay<decltype(e)>::type;
+
+            if constexpr(!std::is_same<Exception_t, monostate>::value &&
+                         !std::is_same<Exception_t, Ret>::value)
+                Ret_except_t{std::move(e)};
+        }, std::move(v));
+    }
+};
+} /* namespace ret_exception */
+
+#endif
@@ -0,0 +1,394 @@
+#ifndef  __return_exception_uring_HPP__
+# define __return_exception_uring_HPP__
+
+# include "ret-exception.hpp"
+# include "ret-exception-io.hpp"
+
+# include <algorithm>
+# include <limits>
+# include <memory>
+# include <type_traits>
+# include <utility>
+
+# include <cstddef>
+# include <cstdint>
+# include <cstring>
+
+# include <linux/io_uring.h>
+# include <sys/syscall.h>
+# include <sys/uio.h>
+# include <unistd.h>
+
+namespace ret_exception::io {
+namespace impl {
+template <class T>
+auto load_acquire(const T *p) noexcept -> T
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+template <class T>
+void store_release(T *p, T val) noexcept
+{
+    __atomic_store_n(p, val, __ATOMIC_RELEASE);
+}
+} /* namespace impl */
+
+/**
+ * A batch of reads and writes submitted with one syscall via io_uring, each of which
+ * completes into a Ret_except slot owned by the caller, thus no allocation is done per
+ * operation.
+ *
+ * If io_uring is not available, the operations are done synchronously by submit_and_wait
+ * instead, which keeps the same interface but takes one syscall per operation.
+ *
+ * Example:
+ *     ret_exception::io::uring<> ring{64};
+ *     decltype(ring)::result_type results[2];
+ *
+ *     (void) ring.prep_read(fd1, buf1, sizeof(buf1), 0, results[0]);
+ *     (void) ring.prep_read(fd2, buf2, sizeof(buf2), 0, results[1]);
+ *     ring.wait_all().Catch(...);
+ *
+ *     for (auto &result: results)
+ *         result.Catch(...);
+ *
+ * The buffer and the slot of every operation must outlive its completion.
+ * A slot must not hold any unhandled exception when its operation completes,
+ * otherwise the program is terminated just like assigning to it.
+ */
+template <unsigned flags = default_flags>
+class uring {
+public:
+    using result_type = io_result<std::size_t, flags>;
+
+private:
+    struct op_t {
+        unsigned char opcode;
+        int fd;
+        void *buf;
+        std::size_t len;
+        off_t offset;
+        result_type *slot;
+    };
+
+    int ring_fd = -1;
+    unsigned entries;
+
+    mapping sq_ring;
+    mapping cq_ring;
+    mapping sqes_map;
+
+    unsigned *sq_head = nullptr;
+    unsigned *sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned *sq_array = nullptr;
+    struct io_uring_sqe *sqes = nullptr;
+
+    unsigned *cq_head = nullptr;
+    unsigned *cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    struct io_uring_cqe *cqes = nullptr;
+
+    /**
+     * Number of operations prepared but not yet consumed by the kernel.
+     */
+    unsigned to_submit = 0;
+    /**
+     * Number of operations consumed by the kernel but not yet harvested.
+     */
+    unsigned in_flight = 0;
+
+    /**
+     * Only allocated if io_uring is not available.
+     */
+    std::unique_ptr<op_t[]> fallback_ops;
+
+    auto setup() noexcept -> io_result<void, flags>
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        auto fd = impl::syscall<flags, int>([&] {
+            return ::syscall(__NR_io_uring_setup, entries, &params);
+        });
+        if (fd.has_exception_set())
+            return {std::move(fd)};
+        ring_fd = fd.get_return_value();
+        entries = params.sq_entries;
+
+        std::size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        std::size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sq_size = cq_size = std::max(sq_size, cq_size);
+
+        auto map = [&](std::size_t len, off_t offset) {
+            return io::mmap<flags>(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   ring_fd, offset);
+        };
+
+        auto sq = map(sq_size, IORING_OFF_SQ_RING);
+        if (sq.has_exception_set())
+            return {std::move(sq)};
+        sq_ring = std::move(sq).get_return_value();
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            cq_ring = mapping{};
+        else {
+            auto cq = map(cq_size, IORING_OFF_CQ_RING);
+            if (cq.has_exception_set())
+                return {std::move(cq)};
+            cq_ring = std::move(cq).get_return_value();
+        }
+
+        auto s = map(params.sq_entries * sizeof(struct io_uring_sqe), IORING_OFF_SQES);
+        if (s.has_exception_set())
+            return {std::move(s)};
+        sqes_map = std::move(s).get_return_value();
+
+        auto *sq_base = static_cast<char*>(sq_ring.data());
+        auto *cq_base = cq_ring.data() ? static_cast<char*>(cq_ring.data()) : sq_base;
+
+        sq_head = reinterpret_cast<unsigned*>(sq_base + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+        sqes = static_cast<struct io_uring_sqe*>(sqes_map.data());
+
+        cq_head = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<struct io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+        return {};
+    }
+
+    void teardown() noexcept
+    {
+        sqes_map = mapping{};
+        cq_ring = mapping{};
+        sq_ring = mapping{};
+        if (ring_fd != -1)
+            (void) ::close(ring_fd);
+        ring_fd = -1;
+    }
+
+    bool prep(unsigned char opcode, int fd, void *buf, std::size_t len, off_t offset,
+              result_type &slot) noexcept
+    {
+        if (to_submit == entries)
+            return false;
+
+        if (fallback_ops) {
+            fallback_ops[to_submit++] = {opcode, fd, buf, len, offset, &slot};
+            return true;
+        }
+
+        unsigned tail = *sq_tail;
+        unsigned index = tail & sq_mask;
+
+        struct io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(buf);
+        sqe.len = static_cast<unsigned>(std::min<std::size_t>(len, std::numeric_limits<unsigned>::max()));
+        sqe.off = static_cast<std::uint64_t>(offset);
+        sqe.user_data = reinterpret_cast<std::uintptr_t>(&slot);
+
+        sq_array[index] = index;
+        impl::store_release(sq_tail, tail + 1);
+        ++to_submit;
+
+        return true;
+    }
+
+    auto run_fallback() -> unsigned
+    {
+        for (unsigned i = 0; i != to_submit; ++i) {
+            const op_t &op = fallback_ops[i];
+            auto *iov = static_cast<const struct iovec*>(op.buf);
+            int iovcnt = static_cast<int>(op.len);
+
+            switch (op.opcode) {
+            case IORING_OP_READ:
+                *op.slot = op.offset == -1 ? io::read<flags>(op.fd, op.buf, op.len) :
+                                             io::pread<flags>(op.fd, op.buf, op.len, op.offset);
+                break;
+            case IORING_OP_WRITE:
+                *op.slot = op.offset == -1 ? io::write<flags>(op.fd, op.buf, op.len) :
+                                             io::pwrite<flags>(op.fd, op.buf, op.len, op.offset);
+                break;
+            case IORING_OP_READV:
+                *op.slot = op.offset == -1 ? io::readv<flags>(op.fd, iov, iovcnt) :
+                                             impl::syscall<flags, std::size_t>([&] {
+                                                 return ::preadv(op.fd, iov, iovcnt, op.offset);
+                                             });
+                break;
+            case IORING_OP_WRITEV:
+                *op.slot = op.offset == -1 ? io::writev<flags>(op.fd, iov, iovcnt) :
+                                             impl::syscall<flags, std::size_t>([&] {
+                                                 return ::pwritev(op.fd, iov, iovcnt, op.offset);
+                                             });
+                break;
+            }
+        }
+
+        unsigned completed = to_submit;
+        to_submit = 0;
+        return completed;
+    }
+
+    /**
+     * Move every completion available into its slot.
+     */
+    auto harvest() -> unsigned
+    {
+        unsigned head = *cq_head;
+        unsigned tail = impl::load_acquire(cq_tail);
+        unsigned completed = tail - head;
+
+        for (; head != tail; ++head) {
+            const struct io_uring_cqe &cqe = cqes[head & cq_mask];
+            auto *slot = reinterpret_cast<result_type*>(static_cast<std::uintptr_t>(cqe.user_data));
+
+            if (cqe.res < 0)
+                *slot = impl::from_errno<flags, std::size_t>(-cqe.res);
+            else
+                slot->set_return_value(static_cast<std::size_t>(cqe.res));
+        }
+        impl::store_release(cq_head, tail);
+
+        in_flight -= completed;
+        return completed;
+    }
+
+    /**
+     * Number of completions available to harvest.
+     */
+    auto harvestable() const noexcept -> unsigned
+    {
+        return impl::load_acquire(cq_tail) - *cq_head;
+    }
+
+public:
+    /**
+     * @param entries maximum number of operations prepared between two submissions.
+     * @param use_io_uring if false, always do the operations synchronously.
+     */
+    explicit uring(unsigned entries = 64, bool use_io_uring = true):
+        entries{entries ? entries : 1}
+    {
+        if (use_io_uring) {
+            auto ret = setup();
+            if (!ret.has_exception_set())
+                return;
+            ret.Catch([](const auto&) {});
+            teardown();
+            this->entries = entries ? entries : 1;
+        }
+        fallback_ops.reset(new op_t[this->entries]);
+    }
+
+    uring(const uring&) = delete;
+    uring& operator = (const uring&) = delete;
+
+    bool is_fallback() const noexcept
+    {
+        return fallback_ops != nullptr;
+    }
+
+    /**
+     * @return number of operations prepared or submitted but not yet completed.
+     */
+    auto pending() const noexcept -> unsigned
+    {
+        return to_submit + in_flight;
+    }
+
+    /**
+     * Prepare a read of fd at offset, or at the current file position if offset is -1.
+     *
+     * @return false if entries operations are already prepared since the last submission,
+     *         in which case nothing is done.
+     */
+    [[nodiscard]] bool prep_read(int fd, void *buf, std::size_t len, off_t offset, result_type &slot) noexcept
+    {
+        return prep(IORING_OP_READ, fd, buf, len, offset, slot);
+    }
+    [[nodiscard]] bool prep_write(int fd, const void *buf, std::size_t len, off_t offset, result_type &slot) noexcept
+    {
+        return prep(IORING_OP_WRITE, fd, const_cast<void*>(buf), len, offset, slot);
+    }
+    [[nodiscard]] bool prep_readv(int fd, const struct iovec *iov, int iovcnt, off_t offset, result_type &slot) noexcept
+    {
+        return prep(IORING_OP_READV, fd, const_cast<struct iovec*>(iov), static_cast<std::size_t>(iovcnt),
+                    offset, slot);
+    }
+    [[nodiscard]] bool prep_writev(int fd, const struct iovec *iov, int iovcnt, off_t offset, result_type &slot) noexcept
+    {
+        return prep(IORING_OP_WRITEV, fd, const_cast<struct iovec*>(iov), static_cast<std::size_t>(iovcnt),
+                    offset, slot);
+    }
+
+    /**
+     * Submit every operation prepared and wait for at least wait_nr of the pending operations
+     * to complete with one syscall, then move every completion available into its slot.
+     *
+     * @return number of operations completed.
+     */
+    auto submit_and_wait(unsigned wait_nr = 0) -> io_result<unsigned, flags>
+    {
+        if (fallback_ops)
+            return {run_fallback()};
+
+        wait_nr = std::min(wait_nr, pending());
+        if (to_submit != 0 || wait_nr > harvestable()) {
+            auto ret = impl::syscall<flags, int>([&] {
+                return ::syscall(__NR_io_uring_enter, ring_fd, to_submit, wait_nr,
+                                 wait_nr ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            });
+
+            // The kernel might have consumed some of the operations even if it failed
+            unsigned submitted = to_submit - (*sq_tail - impl::load_acquire(sq_head));
+            to_submit -= submitted;
+            in_flight += submitted;
+
+            if (ret.has_exception_set())
+                return {std::move(ret)};
+        }
+
+        return {harvest()};
+    }
+
+    /**
+     * Submit every operation prepared and wait for all of them to complete.
+     *
+     * @return number of operations completed.
+     */
+    auto wait_all() -> io_result<unsigned, flags>
+    {
+        unsigned completed = 0;
+        while (pending() != 0) {
+            auto ret = submit_and_wait(pending());
+            if (ret.has_exception_set())
+                return {std::move(ret)};
+            completed += ret.get_return_value();
+        }
+        return {completed};
+    }
+
+    /**
+     * Wait for all operations submitted, since the kernel would still write to their buffers
+     * after the ring is closed.
+     */
+    ~uring()
+    {
+        if (!fallback_ops && pending() != 0)
+            wait_all().Catch([](const auto&) {});
+        teardown();
+    }
+};
+} /* namespace ret_exception::io */
+
+#endif
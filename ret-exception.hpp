@@ -3,30 +3,166 @@
 
 # include <functional>
 # include <utility>
+# include <tuple>
 # include <type_traits>
+# include <new>
+
+# include <cstddef>
+# include <cstdint>
+# include <cstdlib>
 
 # if (__cplusplus >= 201703L)
 #  include <variant>
 # endif
 
 # if !defined(__EXCEPTIONS) || !defined(__cpp_exceptions)
+#  include <atomic>
 #  include <err.h>
 #  include <cstdio>
+#  include <unistd.h>
+# endif
+
+/**
+ * Under C++20, the whole Ret_except_basic_t API is constexpr, so that functions returning
+ * Ret_except can be evaluated at compile time.
+ *
+ * An unhandled exception reached during constant evaluation is a compile error.
+ */
+# if (__cplusplus >= 202002L) && defined(__cpp_lib_is_constant_evaluated)
+#  define RET_EXCEPTION_CONSTEXPR constexpr
+# else
+#  define RET_EXCEPTION_CONSTEXPR
+# endif
+
+/**
+ * Defined to 1 if the move from the result of a conversion function in direct-initialization
+ * is elided (CWG2327), which only GCC implements, so that in_place_invoke accepts Ret
+ * that is not movable.
+ */
+# if defined(__GNUC__) && !defined(__clang__)
+#  define RET_EXCEPTION_ELIDES_CONVERSION 1
+# else
+#  define RET_EXCEPTION_ELIDES_CONVERSION 0
+# endif
+
+namespace ret_exception {
+/**
+ * Policies select at compile time where Ret_except_basic_t checks for unhandled exception.
+ *
+ * A policy has the following members:
+ *  - tracks_handled: whether the "exception handled" bit is reported and respected by the checks.
+ *    If false, has_exception_handled() always returns false, though Catch still dispatches
+ *    an exception only once.
+ *  - check_on_discard: whether the dtor, set_exception and set_return_value check for
+ *    unhandled exception. If false, the dtor is noexcept.
+ *  - check_on_access: whether get_return_value and the conversion operators check for
+ *    unhandled exception.
+ */
+
+/**
+ * Check everywhere, the default.
+ */
+struct enforce_policy {
+    static constexpr bool tracks_handled = true;
+    static constexpr bool check_on_discard = true;
+    static constexpr bool check_on_access = true;
+};
+
+/**
+ * Same as enforce_policy unless NDEBUG is defined, in which case there is no runtime check
+ * and you rely on [[nodiscard]] of Ret_except_basic_t only, which applies under every policy,
+ * so discarding the return value to let the dtor throw must be written as (void) g().
+ */
+struct debug_policy {
+# ifdef NDEBUG
+    static constexpr bool tracks_handled = false;
+    static constexpr bool check_on_discard = false;
+    static constexpr bool check_on_access = false;
+# else
+    static constexpr bool tracks_handled = true;
+    static constexpr bool check_on_discard = true;
+    static constexpr bool check_on_access = true;
 # endif
+};
+
+/**
+ * The handled bit is ignored by the checks and the only check is done when the return value
+ * is accessed: accessing it while holding an exception throws/terminates, whether
+ * the exception is caught or not, while an exception that is never accessed is dropped.
+ */
+struct checked_once_policy {
+    static constexpr bool tracks_handled = false;
+    static constexpr bool check_on_discard = false;
+    static constexpr bool check_on_access = true;
+};
+
+/**
+ * Tag of the constructor of Ret_except_basic_t used by try_make<T>.
+ */
+struct in_place_try_make_t {
+    explicit in_place_try_make_t() = default;
+};
+inline constexpr in_place_try_make_t in_place_try_make{};
+
+/**
+ * Tag of the constructor of Ret_except_basic_t that constructs Ret in place from the return value
+ * of a callable.
+ */
+struct in_place_invoke_t {
+    explicit in_place_invoke_t() = default;
+};
+inline constexpr in_place_invoke_t in_place_invoke{};
+
+template <class E>
+class deferred;
+} /* namespace ret_exception */
+
+template <class Policy, template <typename...> class variant_t, template <class> class in_place_type_t, 
+          class Ret, class ...Ts>
+class Ret_except_basic_t;
 
 template <template <typename...> class variant_t, template <class> class in_place_type_t, 
           class Ret, class ...Ts>
-class Ret_except_t;
+using Ret_except_t = Ret_except_basic_t<ret_exception::enforce_policy, variant_t, in_place_type_t, Ret, Ts...>;
 
 namespace ret_exception::impl {
 struct monostate {};
 
+struct type_name_t {
+    const char *data;
+    std::size_t size;
+};
+
+/**
+ * Extract T from __PRETTY_FUNCTION__, which is "... [with T = int]" on gcc and
+ * "... [T = int]" on clang.
+ */
 template <class T>
-constexpr auto type_name() -> const char*
+constexpr auto type_name() noexcept -> type_name_t
 {
-    return __PRETTY_FUNCTION__ + 49;
+    const char *begin = __PRETTY_FUNCTION__;
+    const char *end = begin;
+    while (*end != '\0')
+        ++end;
+
+    for (const char *it = begin; it + 4 < end; ++it) {
+        if (it[0] == 'T' && it[1] == ' ' && it[2] == '=' && it[3] == ' ') {
+            begin = it + 4;
+            break;
+        }
+    }
+    if (begin != __PRETTY_FUNCTION__ && end[-1] == ']')
+        --end;
+
+    return {begin, static_cast<std::size_t>(end - begin)};
 }
 
+/**
+ * Intentionally not constexpr: reaching it during constant evaluation makes the
+ * evaluation fail and names the reason in the diagnostic.
+ */
+inline void unhandled_exception_in_constant_evaluation() noexcept {}
+
 template <template <typename...> class variant>
 struct variant_non_member_functions_t {};
 
@@ -43,9 +179,104 @@ struct variant_non_member_functions_t<std::variant> {
     {
         return std::get<T>(std::forward<Variant>(v));
     }
+    template <class T, class ...Types>
+    static constexpr auto get_if(std::variant<Types...> *v) noexcept -> T*
+    {
+        return std::get_if<T>(v);
+    }
+    template <class T, class ...Types>
+    static constexpr auto get_if(const std::variant<Types...> *v) noexcept -> const T*
+    {
+        return std::get_if<T>(v);
+    }
 };
 # endif
 
+/**
+ * Base of Ret_except_basic_t storing the "exception handled" bit, which is also the "consumed" bit
+ * that stops Catch from dispatching the same exception twice.
+ *
+ * If the bit is not tracked, is_handled() is always false and nothing is stored here:
+ * Ret_except_basic_t keeps the "consumed" bit next to has_exception instead.
+ */
+template <bool tracks_handled>
+class handled_flag_t {
+    bool is_exception_handled = 0;
+
+protected:
+    constexpr bool is_handled() const noexcept
+    {
+        return is_exception_handled;
+    }
+    constexpr bool is_consumed() const noexcept
+    {
+        return is_exception_handled;
+    }
+    constexpr void set_handled(bool val) noexcept
+    {
+        is_exception_handled = val;
+    }
+};
+
+template <>
+class handled_flag_t<false> {
+protected:
+    constexpr bool is_handled() const noexcept
+    {
+        return false;
+    }
+};
+
+/**
+ * Stored in variant in place of reference Ret, since variant cannot hold reference.
+ */
+template <class T>
+struct ref_t {
+    T *ptr;
+
+    constexpr ref_t(T &ref) noexcept:
+        ptr{&ref}
+    {}
+};
+
+template <class Ret>
+struct stored_ret {
+    using type = Ret;
+
+    template <class U>
+    static constexpr auto unwrap(U &&val) noexcept -> U&&
+    {
+        return std::forward<U>(val);
+    }
+};
+
+template <class T>
+struct stored_ret<T&> {
+    using type = ref_t<T>;
+
+    template <class U>
+    static constexpr auto unwrap(U &&val) noexcept -> T&
+    {
+        return *val.ptr;
+    }
+};
+
+/**
+ * Converts to the return value of f, so that the return value can be constructed in place
+ * by guaranteed copy elision.
+ *
+ * The move is only elided if RET_EXCEPTION_ELIDES_CONVERSION.
+ */
+template <class F>
+struct lazy_t {
+    F &f;
+
+    constexpr operator typename std::invoke_result<F&>::type () const
+    {
+        return std::invoke(f);
+    }
+};
+
 template <class decay_T, class T>
 static constexpr bool is_constructible() noexcept
 {
@@ -67,49 +298,747 @@ static constexpr bool is_nothrow_constructible() noexcept
 template <class Ret_except_t1, class Ret_except_t2>
 class glue_ret_except;
 
-template <template <typename...> class variant1, template <class> class in_place_type_t1, 
+template <class Policy1, template <typename...> class variant1, template <class> class in_place_type_t1, 
           class Ret1, class ...Ts,
-          template <typename...> class variant2, template <class> class in_place_type_t2, 
+          class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2, 
           class Ret2, class ...Tp>
-class glue_ret_except<Ret_except_t<variant1, in_place_type_t1, Ret1, Ts...>, 
-                      Ret_except_t<variant2, in_place_type_t2, Ret2, Tp...>> {
+class glue_ret_except<Ret_except_basic_t<Policy1, variant1, in_place_type_t1, Ret1, Ts...>, 
+                      Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret2, Tp...>> {
 public:
-    using type = Ret_except_t<variant1, in_place_type_t1, Ret1, Ts..., Tp...>;
+    using type = Ret_except_basic_t<Policy1, variant1, in_place_type_t1, Ret1, Ts..., Tp...>;
 };
 
 template <class ...>
 using void_t = void;
 
-// primary template handles types that have no nested ::Ret_except_t member:
-template <class T, class Ret_except_t, class = void_t<>>
-struct glue_ret_except_from {
-    using type = Ret_except_t;
+// primary template handles types that have no nested ::Ret_except_t member:
+template <class T, class Ret_except_t, class = void_t<>>
+struct glue_ret_except_from {
+    using type = Ret_except_t;
+};
+ 
+// specialization recognizes types that do have a nested ::Ret_except_t member:
+template <class T, class Ret_except_t>
+struct glue_ret_except_from<T, Ret_except_t, void_t<typename T::Ret_except_t>>:
+    public glue_ret_except<Ret_except_t, typename T::Ret_except_t>
+{};
+
+template <class Ret_except_t, class ...Ret_except_ts>
+struct glue_all {
+    using type = Ret_except_t;
+};
+
+template <class Ret_except_t1, class Ret_except_t2, class ...Ret_except_ts>
+struct glue_all<Ret_except_t1, Ret_except_t2, Ret_except_ts...>:
+    public glue_all<typename glue_ret_except<Ret_except_t1, Ret_except_t2>::type, Ret_except_ts...>
+{};
+
+template <class T>
+struct deferred_value {
+    using type = void;
+};
+
+template <class E>
+struct deferred_value<deferred<E>> {
+    using type = E;
+};
+
+/**
+ * E if T is deferred<E>, otherwise void.
+ */
+template <class T>
+using deferred_value_t = typename deferred_value<T>::type;
+
+/**
+ * @return true if F is invocable with E, or with T if E is deferred<T>.
+ */
+template <class F, class E>
+constexpr bool is_handler_of() noexcept
+{
+    if constexpr(std::is_invocable<F, E>::value)
+        return true;
+    else if constexpr(!std::is_void<deferred_value_t<E>>::value)
+        return std::is_invocable<F, deferred_value_t<E>>::value;
+    else
+        return false;
+}
+
+/**
+ * @return index of the first F in Fs... that can handle E, or sizeof...(Fs) if none can.
+ */
+template <class E, class ...Fs>
+constexpr std::size_t first_handler_index() noexcept
+{
+    constexpr bool is_invocable[] = {is_handler_of<typename std::decay<Fs>::type, E>()..., false};
+    for (std::size_t i = 0; i != sizeof...(Fs); ++i) {
+        if (is_invocable[i])
+            return i;
+    }
+    return sizeof...(Fs);
+}
+} /* namespace ret_exception::impl */
+
+/**
+ * If Ret_except_t1 and Ret_except_t2 uses different variant impl or policy, the result type
+ * will use the variant impl and policy of Ret_except_t1.
+ */
+template <class Ret_except_t1, class Ret_except_t2>
+using glue_ret_except_t = typename ret_exception::impl::glue_ret_except<Ret_except_t1, Ret_except_t2>::type;
+
+/**
+ * If Ret_except_t and T::Ret_except_t uses different variant impl or policy, the result type
+ * will use the variant impl and policy of Ret_except_t.
+ */
+template <class T, class Ret_except_t>
+using glue_ret_except_from_t = typename ret_exception::impl::glue_ret_except_from<T, Ret_except_t>::type;
+
+namespace ret_exception {
+/**
+ * Describes the type of an unhandled exception to unhandled_exception_handler_t.
+ *
+ * There is exactly one type_id_t per type, so types can be compared by address.
+ */
+struct type_id_t {
+    const char *name;
+    std::size_t name_len;
+
+    /**
+     * Returns e.what() if the payload has one, otherwise formats integers and pointers
+     * into buf and returns buf, otherwise returns nullptr.
+     */
+    const char* (*describe)(const void *payload, char (&buf)[32]) noexcept;
+};
+
+namespace impl {
+template <class T, class = void>
+struct has_what: std::false_type {};
+
+template <class T>
+struct has_what<T, void_t<decltype(static_cast<const char*>(std::declval<const T&>().what()))>>:
+    std::true_type
+{};
+
+inline auto format_integer(char (&buf)[32], unsigned long long val, bool is_negative, 
+                           unsigned base) noexcept -> const char*
+{
+    char *it = buf + sizeof(buf);
+    *--it = '\0';
+    do {
+        *--it = "0123456789abcdef"[val % base];
+        val /= base;
+    } while (val != 0);
+
+    if (base == 16) {
+        *--it = 'x';
+        *--it = '0';
+    }
+    if (is_negative)
+        *--it = '-';
+
+    return it;
+}
+
+template <class T>
+auto describe(const void *payload, char (&buf)[32]) noexcept -> const char*
+{
+    const T &e = *static_cast<const T*>(payload);
+
+    if constexpr(has_what<T>::value)
+        return e.what();
+    else if constexpr(std::is_pointer<T>::value)
+        return format_integer(buf, reinterpret_cast<std::uintptr_t>(e), false, 16);
+    else if constexpr(std::is_integral<T>::value) {
+        if constexpr(std::is_unsigned<T>::value)
+            return format_integer(buf, e, false, 10);
+        else
+            return format_integer(buf, e < 0 ? 0ULL - static_cast<unsigned long long>(e) : e, 
+                                  e < 0, 10);
+    } else
+        return nullptr;
+}
+} /* namespace impl */
+
+template <class T>
+inline constexpr type_id_t type_id_v = {
+    impl::type_name<T>().data,
+    impl::type_name<T>().size,
+    &impl::describe<T>
+};
+
+/**
+ * Context attached to an exception by a frame it propagates through, e.g. {"while parsing field", 3}.
+ *
+ * label must have static storage duration, since it is only read when the context is formatted.
+ */
+struct context_t {
+    const char *label = nullptr;
+    long long value = 0;
+    bool has_value = false;
+
+    context_t() = default;
+
+    constexpr context_t(const char *label) noexcept:
+        label{label}
+    {}
+
+    constexpr context_t(const char *label, long long value) noexcept:
+        label{label}, value{value}, has_value{true}
+    {}
+};
+
+static_assert(std::is_trivially_copyable<context_t>::value);
+
+namespace impl {
+/**
+ * Context of the exception propagating on this thread, innermost first.
+ *
+ * It is not tied to the Ret_except holding the exception, so that moving Ret_except costs nothing,
+ * which limits it to one exception with context per thread at a time:
+ *  - attaching context to a second exception while the first one is unhandled appends to
+ *    the contexts of the first one;
+ *  - handling, throwing or dropping an unhandled exception clears the contexts of every exception;
+ *  - it is cleared before the exception is thrown as C++ exception, so the catch clause
+ *    cannot read it. If exception is disabled, the unhandled exception handler prints it.
+ */
+struct context_chain_t {
+    static constexpr std::size_t capacity = 16;
+
+    context_t records[capacity];
+    std::size_t size = 0;
+    std::size_t dropped = 0;
+};
+
+inline thread_local context_chain_t context_chain;
+
+inline void push_context(const context_t &ctx) noexcept
+{
+    context_chain_t &chain = context_chain;
+    if (chain.size != context_chain_t::capacity)
+        chain.records[chain.size++] = ctx;
+    else
+        ++chain.dropped;
+}
+
+/**
+ * Base of the handler Ret_except uses to take over the exception of another Ret_except,
+ * which keeps the context of the exception.
+ */
+struct matcher_tag {};
+
+RET_EXCEPTION_CONSTEXPR inline void clear_context() noexcept
+{
+# if (__cplusplus >= 202002L) && defined(__cpp_lib_is_constant_evaluated)
+    if (std::is_constant_evaluated())
+        return;
+# endif
+    context_chain.size = 0;
+    context_chain.dropped = 0;
+}
+} /* namespace impl */
+
+/**
+ * Call f(const context_t&) on each context attached to the exception propagating on this thread,
+ * innermost first.
+ *
+ * @return number of contexts dropped since there are more than context_chain_t::capacity of them.
+ */
+template <class F>
+auto for_each_context(F &&f) -> std::size_t
+{
+    const impl::context_chain_t &chain = impl::context_chain;
+    for (std::size_t i = 0; i != chain.size; ++i)
+        f(chain.records[i]);
+    return chain.dropped;
+}
+
+/**
+ * Format the contexts attached to the exception propagating on this thread into buf as
+ * "label value; label value", innermost first, truncated to fit in buf.
+ *
+ * @return length of the string written, excluding the terminating null byte.
+ */
+inline auto format_context(char *buf, std::size_t len) noexcept -> std::size_t
+{
+    if (len == 0)
+        return 0;
+
+    std::size_t pos = 0;
+    auto append = [&](const char *str) noexcept {
+        while (*str != '\0' && pos + 1 < len)
+            buf[pos++] = *str++;
+    };
+
+    char num[32];
+    const impl::context_chain_t &chain = impl::context_chain;
+    for (std::size_t i = 0; i != chain.size; ++i) {
+        const context_t &ctx = chain.records[i];
+
+        if (i != 0)
+            append("; ");
+        if (ctx.label)
+            append(ctx.label);
+        if (ctx.has_value) {
+            append(" ");
+            append(impl::format_integer(num, ctx.value < 0 ? 0ULL - static_cast<unsigned long long>(ctx.value) :
+                                                             ctx.value,
+                                        ctx.value < 0, 10));
+        }
+    }
+    if (chain.dropped != 0) {
+        append("; ");
+        append(impl::format_integer(num, chain.dropped, false, 10));
+        append(" more");
+    }
+
+    buf[pos] = '\0';
+    return pos;
+}
+
+/**
+ * Called with the unhandled exception when exception is disabled.
+ *
+ * It must not return: if it does, std::abort() is called right after it.
+ */
+using unhandled_exception_handler_t = void (*)(const type_id_t &type, const void *payload) noexcept;
+
+# if !defined(__EXCEPTIONS) || !defined(__cpp_exceptions)
+/**
+ * The default handler.
+ *
+ * Writes "[Exception type] description" followed by the contexts attached to it, if any,
+ * straight to fd 2 with write(2) and calls std::abort(), thus it does not pull in stdio and
+ * is async-signal-safe.
+ */
+[[noreturn]] inline void minimal_handler(const type_id_t &type, const void *payload) noexcept
+{
+    char buf[32];
+    const char *desc = type.describe(payload, buf);
+
+    auto write_str = [](const char *str, std::size_t len) noexcept {
+        while (len != 0) {
+            auto cnt = ::write(2, str, len);
+            if (cnt <= 0)
+                return;
+            str += cnt;
+            len -= cnt;
+        }
+    };
+
+    write_str("[Exception ", sizeof("[Exception ") - 1);
+    write_str(type.name, type.name_len);
+    write_str("]", 1);
+    if (desc) {
+        std::size_t len = 0;
+        while (desc[len] != '\0')
+            ++len;
+
+        write_str(" ", 1);
+        write_str(desc, len);
+    }
+
+    char context[256];
+    if (std::size_t len = format_context(context, sizeof(context))) {
+        write_str(" (", 2);
+        write_str(context, len);
+        write_str(")", 1);
+    }
+    write_str("\n", 1);
+
+    std::abort();
+}
+
+/**
+ * Prints the exception using std::fprintf and errx, then exit with 1.
+ */
+[[noreturn]] inline void errx_handler(const type_id_t &type, const void *payload) noexcept
+{
+    char buf[32];
+    const char *desc = type.describe(payload, buf);
+
+    char context[256];
+    format_context(context, sizeof(context));
+
+    std::fprintf(stderr, "[Exception %.*s] ", static_cast<int>(type.name_len), type.name);
+    errx(1, "%s%s%s%s", desc ? desc : "", context[0] ? " (" : "", context, context[0] ? ")" : "");
+}
+
+namespace impl {
+inline std::atomic<unhandled_exception_handler_t> unhandled_exception_handler{&minimal_handler};
+
+template <class T>
+[[noreturn]] void call_unhandled_exception_handler(const T &e) noexcept
+{
+    unhandled_exception_handler.load(std::memory_order_relaxed)(type_id_v<T>, &e);
+    std::abort();
+}
+} /* namespace impl */
+
+/**
+ * Install the handler called on unhandled exception when exception is disabled.
+ *
+ * @param handler nullptr to restore the default minimal_handler.
+ * @return the previous handler.
+ */
+inline auto set_unhandled_exception_handler(unhandled_exception_handler_t handler) noexcept
+    -> unhandled_exception_handler_t
+{
+    if (!handler)
+        handler = &minimal_handler;
+    return impl::unhandled_exception_handler.exchange(handler);
+}
+
+inline auto get_unhandled_exception_handler() noexcept -> unhandled_exception_handler_t
+{
+    return impl::unhandled_exception_handler.load(std::memory_order_relaxed);
+}
+# endif
+
+namespace impl {
+/**
+ * FNV-1a, used to identify types by name, which unlike the address of type_id_v<T>
+ * is the same in every shared library.
+ */
+constexpr auto fnv1a(const char *data, std::size_t len) noexcept -> std::uint64_t
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (std::size_t i = 0; i != len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+template <class F, class = void>
+struct handler_arg {
+    using type = void;
+};
+
+template <class R, class A>
+struct handler_arg<R (*)(A)> {
+    using type = typename std::decay<A>::type;
+};
+template <class R, class A>
+struct handler_arg<R (*)(A) noexcept>: handler_arg<R (*)(A)> {};
+
+template <class R, class C, class A>
+struct handler_arg<R (C::*)(A)>: handler_arg<R (*)(A)> {};
+template <class R, class C, class A>
+struct handler_arg<R (C::*)(A) const>: handler_arg<R (*)(A)> {};
+template <class R, class C, class A>
+struct handler_arg<R (C::*)(A) noexcept>: handler_arg<R (*)(A)> {};
+template <class R, class C, class A>
+struct handler_arg<R (C::*)(A) const noexcept>: handler_arg<R (*)(A)> {};
+
+template <class F>
+struct handler_arg<F, void_t<decltype(&F::operator())>>: handler_arg<decltype(&F::operator())> {};
+
+/**
+ * The decayed type of the only parameter of handler F, or void if F is generic or overloaded.
+ */
+template <class F>
+using handler_arg_t = typename handler_arg<typename std::decay<F>::type>::type;
+} /* namespace impl */
+
+/**
+ * Stable identity of type T, which is the same in every translation unit and shared library
+ * built by the same compiler.
+ */
+template <class T>
+inline constexpr std::uint64_t type_hash_v = impl::fnv1a(type_id_v<T>.name, type_id_v<T>.name_len);
+
+/**
+ * Type-erased exception, for Ret_except<Ret, any_error> used at module boundaries, where
+ * the growing Ts... of glue_ret_except_t costs too much compile time and code.
+ *
+ * Exceptions up to buffer_size bytes that are nothrow movable are stored inline, larger
+ * ones are allocated.
+ *
+ * Ret_except holding any_error can:
+ *  - be constructed from Ret_except of any exceptions, which are put into any_error;
+ *  - be converted to Ret_except<Ret, Ts...>, which takes the exception out of any_error
+ *    if it is in Ts...;
+ *  - Catch(f), in which case f gets the exception inside if f takes it, which is
+ *    matched by type_hash_v instead of rtti.
+ */
+class any_error {
+public:
+    static constexpr std::size_t buffer_size = 32;
+
+private:
+    struct vtable_t {
+        std::uint64_t hash;
+        const type_id_t *type;
+        bool is_inline;
+
+        /**
+         * Move src into dst and destroy src.
+         */
+        void (*move)(void *dst, void *src) noexcept;
+        void (*destroy)(void *storage) noexcept;
+        void (*raise)(void *storage);
+    };
+
+    template <class E>
+    static constexpr bool is_inline = sizeof(E) <= buffer_size && 
+                                      alignof(E) <= alignof(std::max_align_t) &&
+                                      std::is_nothrow_move_constructible<E>::value;
+
+    template <class E>
+    static auto payload_of(void *storage) noexcept -> E*
+    {
+        if constexpr(is_inline<E>)
+            return std::launder(static_cast<E*>(storage));
+        else
+            return *static_cast<E**>(storage);
+    }
+
+    template <class E>
+    static void move_payload(void *dst, void *src) noexcept
+    {
+        if constexpr(is_inline<E>) {
+            E *e = payload_of<E>(src);
+            new (dst) E(std::move(*e));
+            e->~E();
+        } else
+            *static_cast<E**>(dst) = *static_cast<E**>(src);
+    }
+
+    template <class E>
+    static void destroy_payload(void *storage) noexcept
+    {
+        if constexpr(is_inline<E>)
+            payload_of<E>(storage)->~E();
+        else
+            delete payload_of<E>(storage);
+    }
+
+    template <class E>
+    static void raise_payload(void *storage)
+    {
+# if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
+        throw std::move(*payload_of<E>(storage));
+# else
+        impl::call_unhandled_exception_handler(*payload_of<E>(storage));
+# endif
+    }
+
+    template <class E>
+    static constexpr vtable_t vtable_v = {
+        type_hash_v<E>,
+        &type_id_v<E>,
+        is_inline<E>,
+        &move_payload<E>,
+        &destroy_payload<E>,
+        &raise_payload<E>
+    };
+
+    alignas(std::max_align_t) unsigned char storage[buffer_size];
+    const vtable_t *vtable;
+
+public:
+    template <class E, class decay_E = typename std::decay<E>::type,
+              class = typename std::enable_if<!std::is_same<decay_E, any_error>::value &&
+                                              std::is_constructible<decay_E, E>::value>::type>
+    any_error(E &&e) noexcept(is_inline<decay_E> && std::is_nothrow_constructible<decay_E, E>::value):
+        vtable{&vtable_v<decay_E>}
+    {
+        if constexpr(is_inline<decay_E>)
+            new (storage) decay_E(std::forward<E>(e));
+        else
+            *reinterpret_cast<decay_E**>(storage) = new decay_E(std::forward<E>(e));
+    }
+
+    /**
+     * Leaves other empty, which can only be destroyed or assigned to.
+     */
+    any_error(any_error &&other) noexcept:
+        vtable{std::exchange(other.vtable, nullptr)}
+    {
+        if (vtable)
+            vtable->move(storage, other.storage);
+    }
+
+    any_error& operator = (any_error &&other) noexcept
+    {
+        if (this != &other) {
+            this->~any_error();
+            new (this) any_error(std::move(other));
+        }
+        return *this;
+    }
+
+    ~any_error()
+    {
+        if (vtable)
+            vtable->destroy(storage);
+    }
+
+    /**
+     * @pre not moved from
+     */
+    auto type_hash() const noexcept -> std::uint64_t
+    {
+        return vtable->hash;
+    }
+
+    /**
+     * @pre not moved from
+     */
+    auto type() const noexcept -> const type_id_t&
+    {
+        return *vtable->type;
+    }
+
+    template <class E>
+    bool holds() const noexcept
+    {
+        return vtable && vtable->hash == type_hash_v<E>;
+    }
+
+    /**
+     * @return pointer to the exception inside if it is of type E, otherwise nullptr.
+     */
+    template <class E>
+    auto get_if() noexcept -> E*
+    {
+        return holds<E>() ? payload_of<E>(storage) : nullptr;
+    }
+
+    template <class E>
+    auto get_if() const noexcept -> const E*
+    {
+        return const_cast<any_error*>(this)->get_if<E>();
+    }
+
+    /**
+     * Same as type_id_t::describe.
+     *
+     * @pre not moved from
+     */
+    auto describe(char (&buf)[32]) const noexcept -> const char*
+    {
+        return vtable->type->describe(payload(), buf);
+    }
+
+    /**
+     * @pre not moved from
+     */
+    auto payload() const noexcept -> const void*
+    {
+        return const_cast<any_error*>(this)->payload();
+    }
+
+    auto payload() noexcept -> void*
+    {
+        if (vtable->is_inline)
+            return storage;
+        return *reinterpret_cast<void**>(storage);
+    }
+
+    /**
+     * Throw the exception inside as its own type, or pass it to the unhandled exception
+     * handler if exception is disabled.
+     *
+     * @pre not moved from
+     */
+    [[noreturn]] void raise() &&
+    {
+        vtable->raise(storage);
+        std::abort();
+    }
+};
+
+/**
+ * Recipe of exception E, which is only constructed when needed:
+ *  - by a handler of Catch or Catch_all_exhaustive that takes E instead of deferred<E>;
+ *  - when it is unhandled, in which case E is thrown or passed to the unhandled exception handler.
+ *
+ * has_exception_type<E>() of Ret_except holding deferred<E> is true without constructing E.
+ *
+ * The recipe is stored in any_error, so no allocation is made if it fits in any_error::buffer_size.
+ *
+ * Example:
+ *     auto f(int id) -> Ret_except<void, ret_exception::deferred<std::runtime_error>>
+ *     {
+ *         return {ret_exception::deferred<std::runtime_error>{[id] {
+ *             return std::runtime_error{"Request " + std::to_string(id) + " failed"};
+ *         }}};
+ *     }
+ */
+template <class E>
+class deferred {
+    any_error recipe;
+    E (*make)(any_error &recipe);
+
+    template <class F>
+    static auto invoke_recipe(any_error &recipe) -> E
+    {
+        return std::invoke(*static_cast<F*>(recipe.payload()));
+    }
+
+public:
+    using type = E;
+
+    /**
+     * @param f returns E, and is called every time E is constructed.
+     */
+    template <class F, class decay_F = typename std::decay<F>::type,
+              class = typename std::enable_if<!std::is_same<decay_F, deferred>::value &&
+                                              std::is_invocable_r<E, decay_F&>::value>::type>
+    explicit deferred(F &&f):
+        recipe{std::forward<F>(f)}, make{&invoke_recipe<decay_F>}
+    {}
+
+    auto materialize() -> E
+    {
+        return make(recipe);
+    }
+
+    /**
+     * Throw E, or pass it to the unhandled exception handler if exception is disabled.
+     */
+    [[noreturn]] void raise() &&
+    {
+# if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
+        throw materialize();
+# else
+        impl::call_unhandled_exception_handler(static_cast<const E&>(materialize()));
+# endif
+    }
 };
- 
-// specialization recognizes types that do have a nested ::Ret_except_t member:
-template <class T, class Ret_except_t>
-struct glue_ret_except_from<T, Ret_except_t, void_t<typename T::Ret_except_t>>:
-    public glue_ret_except<Ret_except_t, typename T::Ret_except_t>
-{};
-} /* namespace ret_exception::impl */
 
 /**
- * If Ret_except_t1 and Ret_except_t2 uses different variant impl, the result type
- * will use the variant impl of Ret_except_t1.
+ * @return deferred<E> that constructs E from copies of args...
  */
-template <class Ret_except_t1, class Ret_except_t2>
-using glue_ret_except_t = typename ret_exception::impl::glue_ret_except<Ret_except_t1, Ret_except_t2>::type;
+template <class E, class ...Args>
+auto defer(Args &&...args) -> deferred<E>
+{
+    return deferred<E>{[args = std::make_tuple(std::forward<Args>(args)...)] {
+        return std::make_from_tuple<E>(args);
+    }};
+}
 
+namespace impl {
 /**
- * If Ret_except_t and T::Ret_except_t uses different variant impl, the result type
- * will use the variant impl of Ret_except_t.
+ * Invoke f with e, or with E constructed from e if f takes E but e is deferred<E>.
  */
-template <class T, class Ret_except_t>
-using glue_ret_except_from_t = typename ret_exception::impl::glue_ret_except_from<T, Ret_except_t>::type;
+template <class F, class T>
+RET_EXCEPTION_CONSTEXPR decltype(auto) invoke_handler(F &&f, T &&e)
+{
+    if constexpr(std::is_invocable<typename std::decay<F>::type, typename std::decay<T>::type>::value)
+        return std::invoke(std::forward<F>(f), std::forward<T>(e));
+    else
+        return std::invoke(std::forward<F>(f), e.materialize());
+}
+} /* namespace impl */
+
+} /* namespace ret_exception */
 
 /**
  * Ret_except forces the exception returned to be handled, otherwise it would be
  * thrown in destructor.
+ *
+ * Where the check is done is selected by Policy, see ret_exception::enforce_policy.
  * 
  * @tparam variant must has 
  *  - API identical to std::variant, including ADL-lookupable visit,
@@ -117,23 +1046,65 @@ using glue_ret_except_from_t = typename ret_exception::impl::glue_ret_except_fro
  *    provides variant_non_member_t<variant>::holds_alternative, which should
  *    has the same API as std::holds_alternative.
  *  - override std::get for you type
+ *  - provides variant_non_member_t<variant>::get_if, which should has the same API as
+ *    std::get_if, if get_if, get_error_if or value_or is used.
  * @tparam Ts... must not be void or the same type as Ret or has duplicated types.
  */
-template <template <typename...> class variant, template <class> class in_place_type_t, 
+template <class Policy, template <typename...> class variant, template <class> class in_place_type_t, 
           class Ret, class ...Ts>
-class Ret_except_t {
+class [[nodiscard]] Ret_except_basic_t: 
+    private ret_exception::impl::handled_flag_t<Policy::tracks_handled>
+{
     using variant_nonmem_f_t = ret_exception::impl::variant_non_member_functions_t<variant>;
 
-    bool is_exception_handled = 0;
-    bool has_exception = 0;
+    using handled_flag_t = ret_exception::impl::handled_flag_t<Policy::tracks_handled>;
+
+    /**
+     * If the "exception handled" bit is not tracked, bit 1 is the "consumed" bit, so that it
+     * takes no storage, while setting has_exception to 0 or 1 also clears it.
+     */
+    using has_exception_t = typename std::conditional<Policy::tracks_handled, bool, unsigned char>::type;
+    has_exception_t has_exception = 0;
+
+    static constexpr has_exception_t consumed_bit = 2;
+
+    RET_EXCEPTION_CONSTEXPR bool is_consumed() const noexcept
+    {
+        if constexpr(Policy::tracks_handled)
+            return handled_flag_t::is_consumed();
+        else
+            return has_exception & consumed_bit;
+    }
+
+    RET_EXCEPTION_CONSTEXPR void set_handled(bool val) noexcept
+    {
+        if constexpr(Policy::tracks_handled)
+            handled_flag_t::set_handled(val);
+        else if (val && has_exception)
+            has_exception |= consumed_bit;
+        else
+            has_exception &= ~consumed_bit;
+    }
 
     using monostate = ret_exception::impl::monostate;
 
+    static_assert(!std::is_rvalue_reference<Ret>::value, "Ret cannot be rvalue reference");
+
+    /**
+     * If Ret is a reference, it is stored as a pointer.
+     */
+    using stored_ret = ret_exception::impl::stored_ret<Ret>;
+    using stored_ret_t = typename stored_ret::type;
+
     using variant_t = typename std::conditional<std::is_void<Ret>::value, 
                                                 variant<monostate, Ts...>,
-                                                variant<Ret, monostate, Ts...>>::type;
+                                                variant<stored_ret_t, monostate, Ts...>>::type;
     variant_t v;
 
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
+              class Ret_t2, class ...Tps>
+    friend class Ret_except_basic_t;
+
     template <class T>
     static constexpr bool holds_exp() noexcept
     {
@@ -143,58 +1114,180 @@ class Ret_except_t {
     template <class T>
     static constexpr bool holds_type() noexcept
     {
-        return std::is_same<T, Ret>::value || holds_exp<T>();
+        return std::is_same<T, stored_ret_t>::value || holds_exp<T>();
+    }
+
+    template <class T>
+    static constexpr bool materializes() noexcept
+    {
+        if constexpr(std::is_void<ret_exception::impl::deferred_value_t<T>>::value)
+            return false;
+        else
+            return !holds_exp<T>() && holds_exp<ret_exception::impl::deferred_value_t<T>>();
     }
 
-    struct Matcher {
-        Ret_except_t &r;
+    struct Matcher: ret_exception::impl::matcher_tag {
+        Ret_except_basic_t &r;
+
+        RET_EXCEPTION_CONSTEXPR Matcher(Ret_except_basic_t &r) noexcept:
+            r{r}
+        {}
     
         template <class T, class decay_T = typename std::decay<T>::type,
                   class = typename std::enable_if<holds_exp<decay_T>() && 
                                                   ret_exception::impl::is_constructible<decay_T, T>()>::type>
-        void operator () (T &&obj)
+        RET_EXCEPTION_CONSTEXPR void operator () (T &&obj)
             noexcept(ret_exception::impl::is_nothrow_constructible<decay_T, T>())
         {
             r.set_exception<decay_T>(std::forward<T>(obj));
         }
+
+        /**
+         * Put exception not in Ts... into any_error.
+         */
+        template <class T, class decay_T = typename std::decay<T>::type,
+                  class = typename std::enable_if<!holds_exp<decay_T>() && holds_exp<ret_exception::any_error>() &&
+                                                  !std::is_same<decay_T, ret_exception::any_error>::value &&
+                                                  !materializes<decay_T>() &&
+                                                  std::is_constructible<decay_T, T>::value>::type,
+                  class = void>
+        void operator () (T &&obj)
+        {
+            r.template set_exception<ret_exception::any_error>(std::forward<T>(obj));
+        }
+
+        /**
+         * Take the exception out of any_error if it is in Ts...
+         */
+        template <class T, class decay_T = typename std::decay<T>::type,
+                  class = typename std::enable_if<std::is_same<decay_T, ret_exception::any_error>::value &&
+                                                  !holds_exp<ret_exception::any_error>()>::type,
+                  class = void, class = void>
+        void operator () (T &&e)
+        {
+            (unbox<Ts, T>(e) || ...);
+        }
+
+        /**
+         * Construct E from deferred<E> not in Ts... if E is in Ts...
+         */
+        template <class T, class decay_T = typename std::decay<T>::type,
+                  class = typename std::enable_if<materializes<decay_T>()>::type,
+                  class = void, class = void, class = void>
+        void operator () (T &&e)
+        {
+            r.template set_exception<ret_exception::impl::deferred_value_t<decay_T>>(e.materialize());
+        }
+
+        /**
+         * @return true if the exception in e can be taken out by operator ().
+         */
+        template <class T>
+        static bool unboxes(const ret_exception::any_error &e) noexcept
+        {
+            return (unboxes_as<Ts, T>(e) || ...);
+        }
+
+        template <class E, class T>
+        static bool unboxes_as(const ret_exception::any_error &e) noexcept
+        {
+            using E_ref = typename std::conditional<std::is_lvalue_reference<T>::value, E&, E&&>::type;
+            return std::is_constructible<E, E_ref>::value && e.template holds<E>();
+        }
+
+        template <class E, class T>
+        bool unbox(typename std::remove_reference<T>::type &e)
+        {
+            using E_ref = typename std::conditional<std::is_lvalue_reference<T>::value, E&, E&&>::type;
+
+            if constexpr(std::is_constructible<E, E_ref>::value) {
+                if (E *p = e.template get_if<E>()) {
+                    r.template set_exception<E>(static_cast<E_ref>(*p));
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
-    void throw_if_hold_exp()
+    RET_EXCEPTION_CONSTEXPR void throw_if_hold_exp()
     {
-        if (has_exception && !is_exception_handled && !v.valueless_by_exception())
+        if (has_exception && !this->is_handled() && !v.valueless_by_exception())
             visit([this](auto &&e) {
                 using Exception_t = typename std::decay<decltype(e)>::type;
-                if constexpr(!std::is_same<Exception_t, Ret>::value && 
+                if constexpr(!std::is_same<Exception_t, stored_ret_t>::value && 
                              !std::is_same<Exception_t, monostate>::value) {
-                    is_exception_handled = 1;
+                    this->set_handled(1);
+
+# if (__cplusplus >= 202002L) && defined(__cpp_lib_is_constant_evaluated)
+                    if (std::is_constant_evaluated())
+                        ret_exception::impl::unhandled_exception_in_constant_evaluation();
+# endif
+
+# if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
+                    // The handler called when exception is disabled prints the context instead
+                    ret_exception::impl::clear_context();
+# endif
 
+                    if constexpr(std::is_same<Exception_t, ret_exception::any_error>::value ||
+                                 !std::is_void<ret_exception::impl::deferred_value_t<Exception_t>>::value)
+                        std::move(e).raise();
+                    else {
 # if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
-                    throw std::move(e);
+                        throw std::move(e);
 # else
-                    std::fprintf(stderr, "[Exception%s ", ret_exception::impl::type_name<Exception_t>());
-
-                    if constexpr(std::is_base_of<std::exception, Exception_t>::value)
-                        errx(1, "%s", e.what());
-                    else if constexpr(std::is_pointer<Exception_t>::value)
-                        errx(1, "%p", e);
-                    else if constexpr(std::is_integral<Exception_t>::value) {
-                        if constexpr(std::is_unsigned<Exception_t>::value)
-                            errx(1, "%llu", static_cast<unsigned long long>(e));
-                        else
-                            errx(1, "%lld", static_cast<long long>(e));
-                    } else
-                        errx(1, "");
+                        ret_exception::impl::call_unhandled_exception_handler(e);
 # endif
+                    }
                 }
             }, v);
     }
 
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    RET_EXCEPTION_CONSTEXPR void check_on_discard()
+    {
+        if constexpr(Policy::check_on_discard)
+            throw_if_hold_exp();
+        else {
+            // Exception dropped without being handled, e.g. under checked_once_policy
+            if (has_exception && !is_consumed())
+                ret_exception::impl::clear_context();
+        }
+    }
+
+    RET_EXCEPTION_CONSTEXPR void check_on_access()
+    {
+        if constexpr(Policy::check_on_access)
+            throw_if_hold_exp();
+    }
+
+    /**
+     * Whether the exception held by r can be taken by Matcher.
+     *
+     * any_error converted to Ret_except without any_error in Ts... is only taken if
+     * the exception inside is in Ts..., otherwise r is left unhandled, same as exception
+     * of type not in Ts...
+     */
+    template <class Other_ref, class Other = typename std::decay<Other_ref>::type>
+    static RET_EXCEPTION_CONSTEXPR bool accepts_exp(const Other &r) noexcept
+    {
+        if constexpr(!holds_exp<ret_exception::any_error>() && 
+                     Other::template holds_exp<ret_exception::any_error>()) {
+            using other_variant_nonmem_f_t = typename Other::variant_nonmem_f_t;
+
+            auto *e = other_variant_nonmem_f_t::template get_if<ret_exception::any_error>(&r.v);
+            return !e || Matcher::template unboxes<Other_ref>(*e);
+        } else
+            return true;
+    }
+
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps>
-    void from_other(Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &r)
+    RET_EXCEPTION_CONSTEXPR void from_other(Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &r)
     {
-        if (r.has_exception_set())
-            r.Catch(Matcher{*this});
+        if (r.has_exception_set()) {
+            if (accepts_exp<Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...>&>(r))
+                r.Catch(Matcher{*this});
+        }
         else {
             if constexpr(!std::is_void<Ret_t2>::value && !std::is_void<Ret>::value && 
                          std::is_constructible<Ret, Ret_t2>::value)
@@ -202,12 +1295,14 @@ class Ret_except_t {
         }
     }
 
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps>
-    void from_other(Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &&r)
+    RET_EXCEPTION_CONSTEXPR void from_other(Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &&r)
     {
-        if (r.has_exception_set())
-            std::move(r).Catch(Matcher{*this});
+        if (r.has_exception_set()) {
+            if (accepts_exp<Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...>&&>(r))
+                std::move(r).Catch(Matcher{*this});
+        }
         else {
             if constexpr(!std::is_void<Ret_t2>::value && !std::is_void<Ret>::value && 
                          std::is_constructible<Ret, Ret_t2>::value)
@@ -215,12 +1310,64 @@ class Ret_except_t {
         }
     }
 
+    /**
+     * Mark the exception handled by F, which also discards the context attached to it
+     * unless F is Matcher, which propagates the exception to another Ret_except.
+     */
+    template <class F = void>
+    RET_EXCEPTION_CONSTEXPR void handle() noexcept
+    {
+        this->set_handled(1);
+        if constexpr(!std::is_base_of<ret_exception::impl::matcher_tag, typename std::decay<F>::type>::value)
+            ret_exception::impl::clear_context();
+    }
+
+    /**
+     * Handle the exception in any_error by f if f takes any_error or the type of the exception.
+     *
+     * @return true if f is called.
+     */
+    template <class F>
+    bool catch_any_error(ret_exception::any_error &e, F &&f)
+    {
+        using E = ret_exception::impl::handler_arg_t<F>;
+
+        if constexpr(std::is_invocable<typename std::decay<F>::type, ret_exception::any_error&>::value) {
+            handle();
+            std::invoke(std::forward<F>(f), e);
+            return true;
+        } else if constexpr(!std::is_void<E>::value && std::is_invocable<typename std::decay<F>::type, E&>::value) {
+            if (E *p = e.template get_if<E>()) {
+                handle();
+                std::invoke(std::forward<F>(f), *p);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <class F, class ...Fs>
+    static auto exhaustive_any_error(ret_exception::any_error &e, F &&f, Fs &&...fs) -> Ret
+    {
+        using E = ret_exception::impl::handler_arg_t<F>;
+
+        if constexpr(std::is_invocable<typename std::decay<F>::type, ret_exception::any_error>::value)
+            return static_cast<Ret>(std::invoke(std::forward<F>(f), std::move(e)));
+        else {
+            if constexpr(!std::is_void<E>::value && std::is_invocable<typename std::decay<F>::type, E>::value) {
+                if (E *p = e.template get_if<E>())
+                    return static_cast<Ret>(std::invoke(std::forward<F>(f), std::move(*p)));
+            }
+            return exhaustive_any_error(e, std::forward<Fs>(fs)...);
+        }
+    }
+
 public:
     /**
      * If Ret != void, default initializae Ret;
      * Else, construct empty Ret_except that contain no exception.
      */
-    Ret_except_t() = default;
+    Ret_except_basic_t() = default;
 
     /**
      * @tparam T must be in Ts...
@@ -229,12 +1376,22 @@ public:
     template <class T, class decay_T = typename std::decay<T>::type,
               class = typename std::enable_if<holds_type<decay_T>() && 
                                               ret_exception::impl::is_constructible<decay_T, T>()>::type>
-    Ret_except_t(T &&obj)
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(T &&obj)
         noexcept(ret_exception::impl::is_nothrow_constructible<decay_T, T>()):
-            has_exception{!std::is_same<decay_T, Ret>::value},
+            has_exception{!std::is_same<decay_T, stored_ret_t>::value},
             v{in_place_type_t<decay_T>{}, std::forward<T>(obj)}
     {}
 
+    /**
+     * Only available if Ret is a lvalue reference, in which case ref is stored as a pointer.
+     */
+    template <class T = Ret>
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(typename std::enable_if<std::is_lvalue_reference<T>::value, T>::type ref)
+        noexcept:
+            has_exception{0},
+            v{in_place_type_t<stored_ret_t>{}, ref}
+    {}
+
     /**
      * @tparam T must be in Ts...
      * In place construct type T
@@ -242,12 +1399,53 @@ public:
     template <class T, class ...Args, 
               class = typename std::enable_if<holds_type<T>() && 
                                               std::is_constructible<T, Args...>::value>::type>
-    Ret_except_t(in_place_type_t<T> type, Args &&...args)
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(in_place_type_t<T> type, Args &&...args)
         noexcept(std::is_nothrow_constructible<T, Args...>::value):
-            has_exception{!std::is_same<T, Ret>::value}, 
+            has_exception{!std::is_same<T, stored_ret_t>::value}, 
             v{type, std::forward<Args>(args)...}
     {}
 
+    /**
+     * Construct Ret from the return value of f() in the storage of this object.
+     *
+     * Ret must be movable: the variant constructs Ret from a class converting to it, which
+     * only avoids the move ctor of Ret if RET_EXCEPTION_ELIDES_CONVERSION, i.e. on GCC.
+     *
+     * Example:
+     *     return {ret_exception::in_place_invoke, [&] { return Big{...}; }};
+     */
+    template <class F, class T = Ret,
+              class = typename std::enable_if<!std::is_void<T>::value &&
+                                              std::is_invocable_r<T, F&>::value>::type>
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(ret_exception::in_place_invoke_t, F &&f)
+        noexcept(std::is_nothrow_invocable<F&>::value):
+            has_exception{0},
+            v{in_place_type_t<stored_ret_t>{}, ret_exception::impl::lazy_t<F>{f}}
+    {
+# if !RET_EXCEPTION_ELIDES_CONVERSION
+        static_assert(std::is_move_constructible<T>::value,
+                      "in_place_invoke requires movable Ret unless RET_EXCEPTION_ELIDES_CONVERSION");
+# endif
+    }
+
+    /**
+     * Construct Ret in place by Ret(e, args...), then take over the exception Ret reports
+     * via e if there is any, in which case Ret is destroyed.
+     *
+     * Used by try_make<Ret>, which passes a temporary as e, so that Ret is constructed
+     * in the storage of the Ret_except returned without being moved.
+     */
+    template <class T = Ret, class ...Args,
+              class = typename std::enable_if<std::is_constructible<T, typename T::Ret_except_t&, Args...>::value>::type>
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(ret_exception::in_place_try_make_t, typename T::Ret_except_t &&e,
+                                               Args &&...args):
+            has_exception{0},
+            v{in_place_type_t<stored_ret_t>{}, e, std::forward<Args>(args)...}
+    {
+        if (e.has_exception_set())
+            from_other(std::move(e));
+    }
+
     /**
      * This ctor would only cp/mv the exceptions of type Type held by r only if
      * Type is also in Ts...
@@ -255,9 +1453,9 @@ public:
      * Return value is a bit special here: If return value from r is convertible
      * to Ret, then it will be copied if r contains return value.
      */
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps>
-    Ret_except_t(Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &r):
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &r):
             v{in_place_type_t<monostate>{}}
     {
         from_other(r);
@@ -270,27 +1468,27 @@ public:
      * Return value is a bit special here: If return value from r is convertible
      * to Ret, then it will be moved if r contains return value.
      */
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps,
               class = typename std::enable_if<!std::is_same<
-                                          Ret_except_t, 
-                                          Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...>
+                                          Ret_except_basic_t, 
+                                          Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...>
                                       >::value>::type
              >
-    Ret_except_t(Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &&r):
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &&r):
             v{in_place_type_t<monostate>{}}
     {
         from_other(std::move(r));
     }
 
-    Ret_except_t(const Ret_except_t&) = delete;
+    Ret_except_basic_t(const Ret_except_basic_t&) = delete;
 
     /**
      * move constructor is required as NRVO isn't guaranteed to happen.
      */
-    Ret_except_t(Ret_except_t &&other) 
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t(Ret_except_basic_t &&other) 
         noexcept(std::is_nothrow_move_constructible<variant_t>::value):
-            is_exception_handled{other.is_exception_handled},
+            handled_flag_t{other},
             has_exception{other.has_exception},
             v{std::move(other.v)}
     {
@@ -305,9 +1503,9 @@ public:
      * Return value is a bit special here: If return value from r is convertible
      * to Ret, then it will be copied if r contains return value.
      */
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps>
-    Ret_except_t& operator = (Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &r)
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t& operator = (Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &r)
     {
         from_other(std::move(r));
         return *this;
@@ -319,9 +1517,9 @@ public:
      * Return value is a bit special here: If return value from r is convertible
      * to Ret, then it will be moved if r contains return value.
      */
-    template <template <typename...> class variant2, template <class> class in_place_type_t2,
+    template <class Policy2, template <typename...> class variant2, template <class> class in_place_type_t2,
               class Ret_t2, class ...Tps>
-    Ret_except_t& operator = (Ret_except_t<variant2, in_place_type_t2, Ret_t2, Tps...> &&r)
+    RET_EXCEPTION_CONSTEXPR Ret_except_basic_t& operator = (Ret_except_basic_t<Policy2, variant2, in_place_type_t2, Ret_t2, Tps...> &&r)
     {
         from_other(std::move(r));
         return *this;
@@ -335,11 +1533,11 @@ public:
      */
     template <class T, class ...Args, 
               class = typename std::enable_if<holds_exp<T>() && std::is_constructible<T, Args...>::value>::type>
-    void set_exception(Args &&...args)
+    RET_EXCEPTION_CONSTEXPR void set_exception(Args &&...args)
     {
-        throw_if_hold_exp();
+        check_on_discard();
 
-        is_exception_handled = 0;
+        this->set_handled(0);
         has_exception = 1;
         v.template emplace<T>(std::forward<Args>(args)...);
     }
@@ -352,30 +1550,70 @@ public:
      */
     template <class ...Args, 
               class = typename std::enable_if<std::is_constructible<Ret, Args...>::value>::type>
-    void set_return_value(Args &&...args)
+    RET_EXCEPTION_CONSTEXPR void set_return_value(Args &&...args)
     {
-        throw_if_hold_exp();
+        check_on_discard();
 
         has_exception = 0;
-        v.template emplace<Ret>(std::forward<Args>(args)...);
+        v.template emplace<stored_ret_t>(std::forward<Args>(args)...);
     }
 
-    bool has_exception_set() const noexcept
+    RET_EXCEPTION_CONSTEXPR bool has_exception_set() const noexcept
     {
         return has_exception;
     }
-    bool has_exception_handled() const noexcept
+    RET_EXCEPTION_CONSTEXPR bool has_exception_handled() const noexcept
     {
-        return is_exception_handled;
+        return this->is_handled();
+    }
+
+    /**
+     * Attach ctx to the exception held, if there is one, which is kept in a thread_local array
+     * instead of this object until the exception is handled, and only formatted by
+     * ret_exception::format_context on demand.
+     *
+     * Example:
+     *     auto parse_request(int id) -> Ret_except<Request, parse::syntax_error>
+     *     {
+     *         auto r = parse_header(...).add_context({"in request", id});
+     *         ...
+     *     }
+     */
+    auto add_context(const ret_exception::context_t &ctx) & noexcept -> Ret_except_basic_t&
+    {
+        if (has_exception)
+            ret_exception::impl::push_context(ctx);
+        return *this;
+    }
+
+    auto add_context(const ret_exception::context_t &ctx) &&
+        noexcept(std::is_nothrow_move_constructible<variant_t>::value) -> Ret_except_basic_t
+    {
+        if (has_exception)
+            ret_exception::impl::push_context(ctx);
+        return std::move(*this);
     }
 
     /**
-     * Test whether this object contain exception of type T.
+     * Test whether this object contain exception of type T, including T in any_error
+     * and deferred<T>, which is not constructed.
      */
     template <class T>
-    bool has_exception_type() const noexcept
+    RET_EXCEPTION_CONSTEXPR bool has_exception_type() const noexcept
     {
-        return variant_nonmem_f_t::template holds_alternative<T>(v);
+        if constexpr(holds_type<T>())
+            return variant_nonmem_f_t::template holds_alternative<T>(v);
+        else if constexpr(holds_exp<ret_exception::deferred<T>>() || holds_exp<ret_exception::any_error>()) {
+            bool ret = false;
+            if constexpr(holds_exp<ret_exception::deferred<T>>())
+                ret = variant_nonmem_f_t::template holds_alternative<ret_exception::deferred<T>>(v);
+            if constexpr(holds_exp<ret_exception::any_error>()) {
+                auto *e = variant_nonmem_f_t::template get_if<ret_exception::any_error>(&v);
+                ret = ret || (e && e->template holds<T>());
+            }
+            return ret;
+        } else
+            return variant_nonmem_f_t::template holds_alternative<T>(v);
     }
 
     /**
@@ -395,23 +1633,160 @@ public:
      *     }
      */
     template <class F>
-    auto Catch(F &&f) -> Ret_except_t&
+    RET_EXCEPTION_CONSTEXPR auto Catch(F &&f) -> Ret_except_basic_t&
     {
-       if (has_exception && !is_exception_handled && !v.valueless_by_exception())
+       if (has_exception && !this->is_consumed() && !v.valueless_by_exception())
             visit([&, this](auto &&e) {
                 using Exception_t = typename std::decay<decltype(e)>::type;
 
                 if constexpr(!std::is_same<Exception_t, monostate>::value && 
-                             !std::is_same<Exception_t, Ret>::value)
-                    if constexpr(std::is_invocable<typename std::decay<F>::type, Exception_t>::value) {
-                        is_exception_handled = 1;
-                        std::invoke(std::forward<F>(f), std::forward<decltype(e)>(e));
+                             !std::is_same<Exception_t, stored_ret_t>::value) {
+                    if constexpr(ret_exception::impl::is_handler_of<typename std::decay<F>::type, Exception_t>()) {
+                        handle<F>();
+                        ret_exception::impl::invoke_handler(std::forward<F>(f), std::forward<decltype(e)>(e));
+                    } else if constexpr(std::is_same<Exception_t, ret_exception::any_error>::value)
+                        catch_any_error(e, std::forward<F>(f));
+                }
+            }, v);
+
+        return *this;
+    }
+
+    /**
+     * The type of Ret_except that only contains the exceptions that none of Fs... can handle,
+     * which reports at compile time what is left unhandled by Catch(Fs...).
+     */
+    template <class ...Fs>
+    using uncaught_t = typename ret_exception::impl::glue_all<
+        Ret_except_basic_t<Policy, variant, in_place_type_t, Ret>,
+        typename std::conditional<
+            ret_exception::impl::first_handler_index<Ts, Fs...>() == sizeof...(Fs),
+            Ret_except_basic_t<Policy, variant, in_place_type_t, Ret, Ts>,
+            Ret_except_basic_t<Policy, variant, in_place_type_t, Ret>
+        >::type...
+    >::type;
+
+    /**
+     * @return true if every exception in Ts... can be handled by one of Fs...
+     */
+    template <class ...Fs>
+    static constexpr bool catches_all() noexcept
+    {
+        return ((ret_exception::impl::first_handler_index<Ts, Fs...>() != sizeof...(Fs)) && ...);
+    }
+
+    /**
+     * Catch and handle the exception with the first handler that can handle it, which
+     * has the same semantics as f1 and fs... chained by Catch(f), but only dispatch once.
+     *
+     * @post has_exception_set() == true, 
+     *       has_exception_handled() == true if the exception is handled.
+     *
+     * Use uncaught_t<F1, F2, Fs...> to find out which exceptions cannot be handled.
+     *
+     * Example:
+     *     g().Catch([](const std::runtime_error &e) {
+     *         return;
+     *     }, [](const auto &e) {
+     *         throw e;
+     *     });
+     */
+    template <class F1, class F2, class ...Fs>
+    RET_EXCEPTION_CONSTEXPR auto Catch(F1 &&f1, F2 &&f2, Fs &&...fs) -> Ret_except_basic_t&
+    {
+       if (has_exception && !this->is_consumed() && !v.valueless_by_exception())
+            visit([&, this](auto &&e) {
+                using Exception_t = typename std::decay<decltype(e)>::type;
+
+                if constexpr(std::is_same<Exception_t, ret_exception::any_error>::value) {
+                    (void) (catch_any_error(e, std::forward<F1>(f1)) || catch_any_error(e, std::forward<F2>(f2)) ||
+                            (catch_any_error(e, std::forward<Fs>(fs)) || ...));
+                } else if constexpr(!std::is_same<Exception_t, monostate>::value && 
+                                    !std::is_same<Exception_t, stored_ret_t>::value) {
+                    constexpr std::size_t i = 
+                        ret_exception::impl::first_handler_index<Exception_t, F1, F2, Fs...>();
+
+                    if constexpr(i != 2 + sizeof...(Fs)) {
+                        handle();
+                        ret_exception::impl::invoke_handler(std::get<i>(std::forward_as_tuple(std::forward<F1>(f1), 
+                                                                                              std::forward<F2>(f2),
+                                                                                              std::forward<Fs>(fs)...)),
+                                                            std::forward<decltype(e)>(e));
                     }
+                }
             }, v);
 
         return *this;
     }
 
+    /**
+     * Consume this object: return the return value, or the value returned by the first handler
+     * in fs... that can handle the exception.
+     *
+     * fs... must be able to handle every exception in Ts..., which is checked at compile time,
+     * and the return value of them must be convertible to Ret.
+     *
+     * Since every exception is handled, no check for unhandled exception is left, including the
+     * one in dtor, which helps the optimizer to inline the call site.
+     *
+     * If the exception is already handled by Catch, fs... are not called if Ret is void,
+     * otherwise the handler is still called since it is the only source of the return value.
+     *
+     * Example:
+     *     auto g() -> Ret_except<int, PageNotFound, std::runtime_error>;
+     *     int f()
+     *     {
+     *         return g().Catch_all_exhaustive([](const PageNotFound &e) {
+     *             return 404;
+     *         }, [](const auto &e) {
+     *             return 500;
+     *         });
+     *     }
+     */
+    template <class ...Fs>
+    RET_EXCEPTION_CONSTEXPR auto Catch_all_exhaustive(Fs &&...fs) && -> Ret
+    {
+        static_assert(catches_all<Fs...>(), 
+                      "Not all exceptions are handled by fs..., check uncaught_t<Fs...> for them");
+
+        if (!has_exception) {
+            if constexpr(std::is_void<Ret>::value)
+                return;
+            else
+                return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
+        }
+
+        if constexpr(std::is_void<Ret>::value) {
+            if (this->is_consumed()) {
+                has_exception = 0;
+                return;
+            }
+        }
+
+        // Clearing has_exception makes the check in dtor provably dead
+        has_exception = 0;
+        ret_exception::impl::clear_context();
+
+        return visit([&](auto &&e) -> Ret {
+            using Exception_t = typename std::decay<decltype(e)>::type;
+
+            if constexpr(std::is_same<Exception_t, stored_ret_t>::value)
+                return stored_ret::unwrap(std::move(e));
+            else if constexpr(std::is_same<Exception_t, monostate>::value) {
+                if constexpr(!std::is_void<Ret>::value)
+                    return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
+            } else if constexpr(std::is_same<Exception_t, ret_exception::any_error>::value)
+                return exhaustive_any_error(e, std::forward<Fs>(fs)...);
+            else {
+                constexpr std::size_t i = ret_exception::impl::first_handler_index<Exception_t, Fs...>();
+
+                return static_cast<Ret>(
+                    ret_exception::impl::invoke_handler(std::get<i>(std::forward_as_tuple(std::forward<Fs>(fs)...)),
+                                                        std::forward<decltype(e)>(e)));
+            }
+        }, std::move(v));
+    }
+
     /**
      * Get the return value.
      *
@@ -434,10 +1809,10 @@ public:
      *     }
      */
     template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    auto& get_return_value() &
+    RET_EXCEPTION_CONSTEXPR auto& get_return_value() &
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(v);
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(v));
     }
 
     /**
@@ -447,24 +1822,105 @@ public:
      * is called, this would cause the program to terminate.
      */
     template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    auto& get_return_value() const &
+    RET_EXCEPTION_CONSTEXPR auto& get_return_value() const &
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(v);
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(v));
     }
 
     template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    auto&& get_return_value() &&
+    RET_EXCEPTION_CONSTEXPR auto&& get_return_value() &&
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(std::move(v));
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
     }
 
     template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    auto&& get_return_value() const &&
+    RET_EXCEPTION_CONSTEXPR auto&& get_return_value() const &&
+    {
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
+    }
+
+    /**
+     * Get a pointer to the return value, or nullptr if this object does not hold one.
+     *
+     * Never checks for unhandled exception, thus it is only a compare and a load.
+     */
+    template <class T = Ret, 
+              class = typename std::enable_if<std::is_same<T, Ret>::value && !std::is_void<T>::value>::type>
+    RET_EXCEPTION_CONSTEXPR auto get_if() noexcept -> typename std::remove_reference<T>::type*
+    {
+        auto *ret = variant_nonmem_f_t::template get_if<stored_ret_t>(&v);
+        if constexpr(std::is_reference<Ret>::value)
+            return ret ? ret->ptr : nullptr;
+        else
+            return ret;
+    }
+
+    template <class T = Ret, 
+              class = typename std::enable_if<std::is_same<T, Ret>::value && !std::is_void<T>::value>::type>
+    RET_EXCEPTION_CONSTEXPR auto get_if() const noexcept
+        -> typename std::conditional<std::is_reference<T>::value,
+                                     typename std::remove_reference<T>::type*, const T*>::type
+    {
+        auto *ret = variant_nonmem_f_t::template get_if<stored_ret_t>(&v);
+        if constexpr(std::is_reference<Ret>::value)
+            return ret ? ret->ptr : nullptr;
+        else
+            return ret;
+    }
+
+    /**
+     * Get a pointer to the exception of type E, or nullptr if this object does not hold one.
+     *
+     * If E is not in Ts..., it is looked up in any_error.
+     *
+     * @post if the return value is not nullptr, has_exception_handled() == true
+     *
+     * Example:
+     *     auto ret = g();
+     *     if (auto *e = ret.get_error_if<PageNotFound>())
+     *         return e->url;
+     */
+    template <class E, 
+              class = typename std::enable_if<holds_exp<E>() || holds_exp<ret_exception::any_error>()>::type>
+    RET_EXCEPTION_CONSTEXPR auto get_error_if() noexcept -> E*
+    {
+        E *e = nullptr;
+        if constexpr(holds_exp<E>())
+            e = variant_nonmem_f_t::template get_if<E>(&v);
+        else if (auto *any = variant_nonmem_f_t::template get_if<ret_exception::any_error>(&v))
+            e = any->template get_if<E>();
+        if (e)
+            handle();
+        return e;
+    }
+
+    /**
+     * Get the return value if this object holds one, otherwise return default_value.
+     *
+     * Never checks for unhandled exception: asking for a default value is taken as
+     * handling the exception.
+     *
+     * @post if an exception is contained, has_exception_handled() == true
+     */
+    template <class U, class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
+    RET_EXCEPTION_CONSTEXPR auto value_or(U &&default_value) & -> T
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(std::move(v));
+        if (auto *ret = variant_nonmem_f_t::template get_if<stored_ret_t>(&v))
+            return stored_ret::unwrap(*ret);
+        handle();
+        return static_cast<T>(std::forward<U>(default_value));
+    }
+
+    template <class U, class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
+    RET_EXCEPTION_CONSTEXPR auto value_or(U &&default_value) && -> T
+    {
+        if (auto *ret = variant_nonmem_f_t::template get_if<stored_ret_t>(&v))
+            return stored_ret::unwrap(std::move(*ret));
+        handle();
+        return static_cast<T>(std::forward<U>(default_value));
     }
 
     /**
@@ -472,42 +1928,44 @@ public:
      *
      * If an exception is contained in this object and it is not handled when this function
      * is called, this would cause the program to terminate.
+     *
+     * T is not deduced from the target type, so that Ret can be a reference.
      */
-    template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    operator T&() &
+    template <class T = Ret>
+    RET_EXCEPTION_CONSTEXPR operator typename std::enable_if<!std::is_void<T>::value, T>::type&() &
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(v);
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(v));
     }
 
-    template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    operator const T&() const &
+    template <class T = Ret>
+    RET_EXCEPTION_CONSTEXPR operator const typename std::enable_if<!std::is_void<T>::value, T>::type&() const &
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(v);
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(v));
     }
 
-    template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    operator T&&() &&
+    template <class T = Ret>
+    RET_EXCEPTION_CONSTEXPR operator typename std::enable_if<!std::is_void<T>::value, T>::type&&() &&
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(std::move(v));
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
     }
 
-    template <class T = Ret, class = typename std::enable_if<!std::is_void<T>::value>::type>
-    operator const T&&() const &&
+    template <class T = Ret>
+    RET_EXCEPTION_CONSTEXPR operator const typename std::enable_if<!std::is_void<T>::value, T>::type&&() const &&
     {
-        throw_if_hold_exp();
-        return variant_nonmem_f_t::template get<Ret>(std::move(v));
+        check_on_access();
+        return stored_ret::unwrap(variant_nonmem_f_t::template get<stored_ret_t>(std::move(v)));
     }
 
     /**
      * If an exception is contained in this object and it is not handled when dtor
      * is called, this would cause the program to terminate.
      */
-    ~Ret_except_t() noexcept(false)
+    RET_EXCEPTION_CONSTEXPR ~Ret_except_basic_t() noexcept(!Policy::check_on_discard)
     {
-        throw_if_hold_exp();
+        check_on_discard();
     }
 };
 
@@ -517,6 +1975,12 @@ public:
  */
 template <class Ret, class ...Ts>
 using Ret_except = Ret_except_t<std::variant, std::in_place_type_t, Ret, Ts...>;
+
+/**
+ * Ret_except with check selected by Policy, e.g. ret_exception::debug_policy.
+ */
+template <class Policy, class Ret, class ...Ts>
+using Ret_except_p = Ret_except_basic_t<Policy, std::variant, std::in_place_type_t, Ret, Ts...>;
 # endif
 
 /**
@@ -536,9 +2000,63 @@ using Ret_except = Ret_except_t<std::variant, std::in_place_type_t, Ret, Ts...>;
  * use std::is_constructible_v<type, Ret_except_detector_t>.
  */
 struct Ret_except_detector_t {
-    template <template <typename...> class variant, template <class> class in_place_type_t, 
+    template <class Policy, template <typename...> class variant, template <class> class in_place_type_t, 
               class Ret, class ...Ts>
-    operator Ret_except_t<variant, in_place_type_t, Ret, Ts...>& () const noexcept;
+    operator Ret_except_basic_t<Policy, variant, in_place_type_t, Ret, Ts...>& () const noexcept;
 };
 
+namespace ret_exception {
+namespace impl {
+template <class T, class = void>
+struct has_ret_except_t: std::false_type {};
+
+template <class T>
+struct has_ret_except_t<T, void_t<typename T::Ret_except_t>>: std::true_type {};
+
+template <class T, class = void, class ...Args>
+struct has_try_create: std::false_type {};
+
+template <class T, class ...Args>
+struct has_try_create<T, void_t<decltype(T::try_create(std::declval<Args>()...))>, Args...>:
+    std::true_type
+{};
+} /* namespace impl */
+
+/**
+ * Construct T that might fail, without moving it:
+ *  - If T has static member function try_create(args...), return its return value;
+ *  - Else if T reports failure via its first parameter, i.e.
+ *    std::is_constructible_v<T, Ret_except_detector_t, Args...>, T must define
+ *    T::Ret_except_t as the type of that parameter, and
+ *    glue_ret_except_from_t<T, Ret_except<T>> is returned;
+ *  - Else return Ret_except<T>.
+ *
+ * Example:
+ *     class Connection {
+ *     public:
+ *         using Ret_except_t = Ret_except<void, Timeout>;
+ *
+ *         Connection(Ret_except_t &e, const char *addr);
+ *         Connection(Connection&&) = delete;
+ *     };
+ *
+ *     auto conn = ret_exception::try_make<Connection>("localhost");
+ *     conn.Catch([](Timeout) { ... });
+ */
+template <class T, class ...Args>
+auto try_make(Args &&...args)
+{
+    if constexpr(impl::has_try_create<T, void, Args&&...>::value)
+        return T::try_create(std::forward<Args>(args)...);
+    else if constexpr(std::is_constructible<T, Ret_except_detector_t, Args&&...>::value) {
+        static_assert(impl::has_ret_except_t<T>::value,
+                      "T must define T::Ret_except_t as the type of its first parameter");
+
+        using Result = glue_ret_except_from_t<T, Ret_except<T>>;
+        return Result{in_place_try_make, typename T::Ret_except_t{}, std::forward<Args>(args)...};
+    } else
+        return Ret_except<T>{std::in_place_type<T>, std::forward<Args>(args)...};
+}
+} /* namespace ret_exception */
+
 #endif
@@ -145,5 +145,204 @@ int main(int argc, char* argv[])
         assert(false);
     }
 
+    // Test get_if + value_or + get_error_if
+    try {
+        Ret_except<char, int, void*> r{'c'};
+        assert(*r.get_if() == 'c');
+        assert(r.get_error_if<int>() == nullptr);
+        assert(r.value_or('d') == 'c');
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        Ret_except<char, int, void*> r{-1};
+        assert(r.get_if() == nullptr);
+        assert(r.get_error_if<void*>() == nullptr);
+        assert(!r.has_exception_handled());
+        assert(*r.get_error_if<int>() == -1);
+        assert(r.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        Ret_except<char, int, void*> r{-1};
+        assert(r.value_or('d') == 'd');
+        assert(r.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+
+    // Test multi-handler Catch: first match wins, same as chained Catch
+    try {
+        Ret_except<char, int, long, void*> r{-1L};
+
+        bool is_visited = false;
+        r.Catch([](void *p) {
+            assert(false);
+        }, [&](long l) {
+            assert(!is_visited);
+            assert(l == -1);
+            is_visited = true;
+        }, [](auto e) {
+            assert(false);
+        });
+        assert(is_visited);
+        assert(r.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test multi-handler Catch: exceptions left unhandled
+    {
+        using R = Ret_except<char, int, long, void*>;
+        auto on_ptr = [](void*) {};
+        auto on_long = [](long) {};
+
+        static_assert(std::is_same_v<R::uncaught_t<decltype(on_ptr)>, Ret_except<char, int, long>>);
+        static_assert(std::is_same_v<R::uncaught_t<decltype(on_ptr), decltype(on_long)>, 
+                                     Ret_except<char>>);
+        static_assert(!R::catches_all<decltype(on_ptr)>());
+        static_assert(R::catches_all<decltype(on_ptr), decltype(on_long)>());
+    }
+
+    try {
+        Ret_except<char, int, void*> r{-1};
+
+        r.Catch([](void *p) {
+            assert(false);
+        }, [](const char *p) {
+            assert(false);
+        });
+        assert(!r.has_exception_handled());
+        r.Catch([](int) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test Catch_all_exhaustive
+    try {
+        auto handlers = [](Ret_except<int, char, void*> &&r) {
+            return std::move(r).Catch_all_exhaustive([](void*) {
+                return -1;
+            }, [](char c) {
+                return static_cast<int>(c);
+            });
+        };
+
+        assert(handlers(Ret_except<int, char, void*>{1}) == 1);
+        assert(handlers(Ret_except<int, char, void*>{'c'}) == 'c');
+        assert(handlers(Ret_except<int, char, void*>{static_cast<void*>(nullptr)}) == -1);
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        bool is_visited = false;
+        Ret_except<void, int>{-1}.Catch_all_exhaustive([&](int i) {
+            assert(i == -1);
+            is_visited = true;
+        });
+        assert(is_visited);
+
+        int calls = 0;
+        Ret_except<void, int> r{-1};
+        r.Catch([&](int) {
+            ++calls;
+        });
+        std::move(r).Catch_all_exhaustive([&](int) {
+            ++calls;
+        });
+        assert(calls == 1);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test checked_once_policy: "consumed" bit shares the byte of has_exception, no check in dtor
+    static_assert(sizeof(Ret_except_p<ret_exception::checked_once_policy, long, int>) <= 
+                  sizeof(Ret_except<long, int>));
+    static_assert(sizeof(Ret_except_p<ret_exception::checked_once_policy, char, signed char>) ==
+                  sizeof(std::variant<char, signed char>) + 1);
+    static_assert(std::is_nothrow_destructible_v<Ret_except_p<ret_exception::checked_once_policy, 
+                                                              long, int>>);
+    static_assert(!std::is_nothrow_destructible_v<Ret_except<long, int>>);
+    try {
+        Ret_except_p<ret_exception::checked_once_policy, char, int> r{-1};
+        assert(r.has_exception_type<int>());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test checked_once_policy: get_return_value checks
+    try {
+        Ret_except_p<ret_exception::checked_once_policy, char, int> r{-1};
+        r.Catch([](int) {});
+        assert(!r.has_exception_handled());
+        assert(r.get_return_value() == 'c');
+        assert(false);
+    } catch (int i) {
+        assert(i == -1);
+    }
+
+    // Test debug_policy: behaves like enforce_policy without NDEBUG
+    try {
+        Ret_except_p<ret_exception::debug_policy, char, int> r{-1};
+    } catch (int i) {
+        assert(i == -1);
+    }
+
+    // Test chained Catch dispatches only once under every policy
+    auto count_chained_catch = [](auto r) {
+        int calls = 0;
+        r.Catch([&](int) {
+            ++calls;
+        }).Catch([&](const auto&) {
+            ++calls;
+        });
+        return calls;
+    };
+    auto count_multi_catch = [](auto r) {
+        int calls = 0;
+        r.Catch([&](int) {
+            ++calls;
+        }, [&](const auto&) {
+            ++calls;
+        });
+        r.Catch([&](int) {
+            ++calls;
+        }, [&](const auto&) {
+            ++calls;
+        });
+        return calls;
+    };
+    try {
+        assert(count_chained_catch(Ret_except_p<ret_exception::enforce_policy, char, int>{-1}) == 1);
+        assert(count_chained_catch(Ret_except_p<ret_exception::debug_policy, char, int>{-1}) == 1);
+        assert(count_chained_catch(Ret_except_p<ret_exception::checked_once_policy, char, int>{-1}) == 1);
+
+        assert(count_multi_catch(Ret_except_p<ret_exception::enforce_policy, char, int>{-1}) == 1);
+        assert(count_multi_catch(Ret_except_p<ret_exception::debug_policy, char, int>{-1}) == 1);
+        assert(count_multi_catch(Ret_except_p<ret_exception::checked_once_policy, char, int>{-1}) == 1);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test converting between policies
+    try {
+        Ret_except_p<ret_exception::checked_once_policy, char, int> r2{-1};
+        Ret_except<long, void*, int> r1{std::move(r2)};
+
+        bool is_visited = false;
+        r1.Catch([&](int i) {
+            assert(i == -1);
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+
     return 0;
 }
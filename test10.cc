@@ -0,0 +1,133 @@
+#include "ret-exception-io.hpp"
+#include <cassert>
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace io = ret_exception::io;
+
+int main(int argc, char* argv[])
+{
+    static_assert(std::is_same_v<io::io_result<std::size_t, io::default_flags>, 
+                                 Ret_except<std::size_t, io::sys_error>>);
+    static_assert(std::is_same_v<io::io_result<std::size_t, io::report_eintr | io::report_eagain>, 
+                                 Ret_except<std::size_t, io::interrupted, io::would_block, io::sys_error>>);
+
+    // Test write + read on pipe
+    try {
+        int fds[2];
+        assert(pipe(fds) == 0);
+
+        assert(io::write(fds[1], std::string_view{"hello"}).get_return_value() == 5);
+
+        std::array<char, 16> buf;
+        assert(io::read(fds[0], buf).get_return_value() == 5);
+        assert((std::string_view{buf.data(), 5} == "hello"));
+
+        // Test EAGAIN reported as would_block
+        assert(fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+        bool is_visited = false;
+        io::read<io::report_eagain>(fds[0], buf).Catch([&](io::would_block) {
+            is_visited = true;
+        }).Catch([](const auto&) {
+            assert(false);
+        });
+        assert(is_visited);
+
+        // Test EAGAIN reported as sys_error by default
+        is_visited = false;
+        io::read(fds[0], buf).Catch([&](io::sys_error e) {
+            assert(e.code == std::errc::operation_would_block);
+            is_visited = true;
+        });
+        assert(is_visited);
+
+        assert(!io::close(fds[0]).has_exception_set());
+        assert(!io::close(fds[1]).has_exception_set());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test send + recv on socketpair
+    try {
+        int fds[2];
+        assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+        assert(io::send(fds[0], "ping", 4).get_return_value() == 4);
+
+        char buf[4];
+        assert(io::recv(fds[1], buf, sizeof(buf)).get_return_value() == 4);
+        assert((std::string_view{buf, 4} == "ping"));
+
+        bool is_visited = false;
+        io::recv<io::report_eagain>(fds[1], buf, sizeof(buf), MSG_DONTWAIT).Catch([&](io::would_block) {
+            is_visited = true;
+        }).Catch([](const auto&) {
+            assert(false);
+        });
+        assert(is_visited);
+
+        assert(!io::close(fds[0]).has_exception_set());
+        assert(!io::close(fds[1]).has_exception_set());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test open failure
+    try {
+        bool is_visited = false;
+        io::open("/nonexistent/file", O_RDONLY).Catch([&](io::sys_error e) {
+            assert(e.code == std::errc::no_such_file_or_directory);
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test pwrite + pread + readv + mmap_file on a file
+    try {
+        char path[] = "/tmp/ret-exception-test10-XXXXXX";
+        int fd = mkstemp(path);
+        assert(fd != -1);
+        unlink(path);
+
+        assert(io::pwrite(fd, "0123456789", 10, 0).get_return_value() == 10);
+
+        char buf[4];
+        assert(io::pread(fd, buf, 4, 3).get_return_value() == 4);
+        assert((std::string_view{buf, 4} == "3456"));
+
+        char buf1[2], buf2[3];
+        struct iovec iov[] = {{buf1, sizeof(buf1)}, {buf2, sizeof(buf2)}};
+        assert(lseek(fd, 0, SEEK_SET) == 0);
+        assert(io::readv(fd, iov, 2).get_return_value() == 5);
+        assert((std::string_view{buf1, 2} == "01"));
+        assert((std::string_view{buf2, 3} == "234"));
+
+        auto mapping = io::mmap_file(fd);
+        assert(mapping.get_return_value().as_string_view() == "0123456789");
+        assert(lseek(fd, 0, SEEK_CUR) == 5);
+
+        assert(!io::close(fd).has_exception_set());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test bad fd
+    try {
+        bool is_visited = false;
+        io::close(-1).Catch([&](io::sys_error e) {
+            assert(e.code == std::errc::bad_file_descriptor);
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
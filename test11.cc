@@ -0,0 +1,140 @@
+#include "ret-exception-uring.hpp"
+#include <cassert>
+#include <string_view>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace io = ret_exception::io;
+
+template <class Ring>
+void test_ring(Ring &ring)
+{
+    using result_type = typename Ring::result_type;
+
+    // Test pwrite + pread + preadv on file
+    {
+        char path[] = "/tmp/ret-exception-test11-XXXXXX";
+        int fd = mkstemp(path);
+        assert(fd != -1);
+        unlink(path);
+
+        result_type results[4];
+        bool is_prepared = ring.prep_write(fd, "0123456789", 10, 0, results[0]);
+        assert(is_prepared);
+        unsigned completed = ring.wait_all().get_return_value();
+        assert(completed == 1);
+        assert(results[0].get_return_value() == 10);
+
+        char buf1[4], buf2[3];
+        char buf3[2], buf4[2];
+        struct iovec iov[] = {{buf3, sizeof(buf3)}, {buf4, sizeof(buf4)}};
+        is_prepared = ring.prep_read(fd, buf1, sizeof(buf1), 0, results[1]) &&
+                      ring.prep_read(fd, buf2, sizeof(buf2), 7, results[2]) &&
+                      ring.prep_readv(fd, iov, 2, 4, results[3]);
+        assert(is_prepared);
+        assert(ring.pending() == 3);
+        completed = ring.wait_all().get_return_value();
+        assert(completed == 3);
+        assert(ring.pending() == 0);
+
+        assert(results[1].get_return_value() == 4);
+        assert((std::string_view{buf1, 4} == "0123"));
+        assert(results[2].get_return_value() == 3);
+        assert((std::string_view{buf2, 3} == "789"));
+        assert(results[3].get_return_value() == 4);
+        assert((std::string_view{buf3, 2} == "45"));
+        assert((std::string_view{buf4, 2} == "67"));
+
+        bool is_failed = io::close(fd).has_exception_set();
+        assert(!is_failed);
+    }
+
+    // Test write + read on pipe
+    {
+        int fds[2];
+        int ret = pipe(fds);
+        assert(ret == 0);
+
+        result_type results[2];
+        char buf[16];
+        bool is_prepared = ring.prep_write(fds[1], "hello", 5, -1, results[0]) &&
+                           ring.prep_read(fds[0], buf, sizeof(buf), -1, results[1]);
+        assert(is_prepared);
+        unsigned completed = ring.wait_all().get_return_value();
+        assert(completed == 2);
+
+        assert(results[0].get_return_value() == 5);
+        assert(results[1].get_return_value() == 5);
+        assert((std::string_view{buf, 5} == "hello"));
+
+        bool is_failed = io::close(fds[0]).has_exception_set();
+        is_failed |= io::close(fds[1]).has_exception_set();
+        assert(!is_failed);
+    }
+
+    // Test error is completed into slot
+    {
+        result_type result;
+        char buf[1];
+        bool is_prepared = ring.prep_read(-1, buf, sizeof(buf), 0, result);
+        assert(is_prepared);
+        unsigned completed = ring.wait_all().get_return_value();
+        assert(completed == 1);
+
+        bool is_visited = false;
+        result.Catch([&](io::sys_error e) {
+            assert(e.code == std::errc::bad_file_descriptor);
+            is_visited = true;
+        });
+        assert(is_visited);
+    }
+
+    // Test queue is full
+    {
+        result_type results[5];
+        char buf[1];
+        int fd = ::open("/dev/zero", O_RDONLY);
+        assert(fd != -1);
+
+        unsigned prepared = 0;
+        while (prepared != 5 && ring.prep_read(fd, buf, sizeof(buf), 0, results[prepared]))
+            ++prepared;
+        assert(prepared == 4);
+
+        unsigned completed = ring.submit_and_wait(4).get_return_value();
+        assert(completed == 4);
+        bool is_prepared = ring.prep_read(fd, buf, sizeof(buf), 0, results[4]);
+        assert(is_prepared);
+        completed = ring.wait_all().get_return_value();
+        assert(completed == 1);
+
+        for (auto &result: results)
+            assert(result.get_return_value() == 1);
+
+        bool is_failed = io::close(fd).has_exception_set();
+        assert(!is_failed);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        io::uring<> ring{4};
+        if (ring.is_fallback())
+            std::fputs("test11: io_uring is not available, testing the fallback only\n", stderr);
+        test_ring(ring);
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        io::uring<> ring{4, false};
+        assert(ring.is_fallback());
+        test_ring(ring);
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
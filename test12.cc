@@ -0,0 +1,204 @@
+#include "ret-exception-parse.hpp"
+#include <cassert>
+#include <charconv>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cinttypes>
+
+namespace parse = ret_exception::parse;
+
+template <class T>
+auto parse_all(std::string_view s) -> parse::parse_number_result<T>
+{
+    parse::cursor c{s};
+    if constexpr(std::is_integral<T>::value)
+        return parse::parse_int<T>(c);
+    else
+        return parse::parse_float<T>(c);
+}
+
+template <class T>
+void check_like_from_chars(std::string_view s)
+{
+    T expected;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), expected);
+
+    parse::cursor c{s, 100};
+    parse::parse_number_result<T> r;
+    if constexpr(std::is_integral<T>::value)
+        r = parse::parse_int<T>(c);
+    else
+        r = parse::parse_float<T>(c);
+
+    if (ec == std::errc::invalid_argument) {
+        assert(r.template get_error_if<parse::invalid_number>()->offset == 100);
+        assert(c.offset() == 100);
+    } else if (ec == std::errc::result_out_of_range) {
+        assert(r.template get_error_if<parse::number_out_of_range>()->offset == 100);
+        assert(c.offset() == 100);
+    } else {
+        if constexpr(std::is_integral<T>::value)
+            assert(r.get_return_value() == expected);
+        else
+            assert(std::memcmp(&r.get_return_value(), &expected, sizeof(T)) == 0 ||
+                   (std::isnan(expected) && std::isnan(r.get_return_value())));
+        assert(c.rest().data() == ptr);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Test parse_int
+    try {
+        assert(parse_all<int>("0").get_return_value() == 0);
+        assert(parse_all<int>("-0").get_return_value() == 0);
+        assert(parse_all<int>("12345678901").get_error_if<parse::number_out_of_range>());
+        assert(parse_all<int>("x").get_error_if<parse::invalid_number>());
+
+        for (auto s: {"0", "1", "-1", "42abc", "12345678", "123456789", "-x", "", "+1", "abc",
+                      "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+                      "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+                      "000000000000000000000000000012", "99999999999999999999999"}) {
+            check_like_from_chars<std::int64_t>(s);
+            check_like_from_chars<std::uint64_t>(s);
+            check_like_from_chars<std::int32_t>(s);
+            check_like_from_chars<std::uint8_t>(s);
+            check_like_from_chars<std::int8_t>(s);
+        }
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test parse_float
+    try {
+        for (auto s: {"0", "-0", "1.5", ".5", "5.", "1e10", "1e-10", "1.e5", "1e", "1e+", "-",
+                      ".", "inf", "-nan", "1e400", "1e-400", "123456789012345678901234567890",
+                      "0.1", "3.14159265358979323846", "2.2250738585072014e-308", "1.7976931348623157e308",
+                      "9007199254740993", "1E22", "1e23", "x", ""}) {
+            check_like_from_chars<double>(s);
+            check_like_from_chars<float>(s);
+        }
+
+        std::mt19937_64 rng{42};
+        char buf[64];
+        for (int i = 0; i != 100000; ++i) {
+            std::uint64_t m = rng() >> (rng() % 64);
+            int e = static_cast<int>(rng() % 60) - 30;
+            std::snprintf(buf, sizeof(buf), "%" PRIu64 "e%d", m, e);
+            check_like_from_chars<double>(buf);
+            check_like_from_chars<float>(buf);
+
+            std::snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(rng() % 12),
+                          static_cast<double>(m) / 1000);
+            check_like_from_chars<double>(buf);
+            check_like_from_chars<float>(buf);
+        }
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test expect
+    try {
+        parse::cursor c{"1,2", 10};
+        assert(parse::parse_int<int>(c).get_return_value() == 1);
+        assert(!parse::expect(c, ',').has_exception_set());
+        assert(parse::parse_int<int>(c).get_return_value() == 2);
+        assert(c.empty());
+
+        auto r = parse::expect(c, ',');
+        assert(r.get_error_if<parse::syntax_error>()->offset == 13);
+    } catch (...) {
+        assert(false);
+    }
+
+    const std::string input = "1,2\n3,4\n\n5,x\n7,8";
+
+    auto parse_line = [](std::vector<int> &sums) {
+        return [&](parse::cursor &c) -> Ret_except<void, parse::invalid_number, parse::number_out_of_range,
+                                                   parse::syntax_error> {
+            if (c.empty())
+                return {};
+
+            auto x = parse::parse_int<int>(c);
+            if (x.has_exception_set())
+                return {std::move(x)};
+            auto comma = parse::expect(c, ',');
+            if (comma.has_exception_set())
+                return {std::move(comma)};
+            auto y = parse::parse_int<int>(c);
+            if (y.has_exception_set())
+                return {std::move(y)};
+
+            sums.push_back(x.get_return_value() + y.get_return_value());
+            return {};
+        };
+    };
+
+    // Test for_each_record
+    try {
+        std::vector<int> sums;
+        bool is_visited = false;
+        parse::for_each_record(input, '\n', parse_line(sums)).Catch([&](parse::invalid_number e) {
+            assert(e.offset == 11);
+            is_visited = true;
+        });
+        assert(is_visited);
+        assert((sums == std::vector<int>{3, 7}));
+
+        sums.clear();
+        assert(!parse::for_each_record("1,2\n3,4\n5,6", '\n', parse_line(sums)).has_exception_set());
+        assert((sums == std::vector<int>{3, 7, 11}));
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test for_each_record_chunked with a chunk smaller than a record
+    struct eof_error {};
+    for (std::size_t chunk_size: {1, 2, 3, 64}) {
+        try {
+            std::string_view remaining = "1,2\n3,4\n\n5,6\n12345,1";
+            auto reader = [&](char *buf, std::size_t len) -> Ret_except<std::size_t, eof_error> {
+                len = std::min<std::size_t>(len, 2);
+                remaining.copy(buf, len);
+                len = std::min(len, remaining.size());
+                remaining.remove_prefix(len);
+                return len;
+            };
+
+            std::vector<int> sums;
+            auto r = parse::for_each_record_chunked(reader, '\n', parse_line(sums), chunk_size);
+            assert(!r.has_exception_set());
+            assert((sums == std::vector<int>{3, 7, 11, 12346}));
+
+            remaining = input;
+            sums.clear();
+            parse::for_each_record_chunked(reader, '\n', parse_line(sums), chunk_size)
+                .Catch([&](parse::invalid_number e) {
+                    assert(e.offset == 11);
+                }).Catch([](const auto&) {
+                    assert(false);
+                });
+            assert((sums == std::vector<int>{3, 7}));
+
+            bool is_visited = false;
+            parse::for_each_record_chunked([](char*, std::size_t) -> Ret_except<std::size_t, eof_error> {
+                return {eof_error{}};
+            }, '\n', parse_line(sums), chunk_size).Catch([&](eof_error) {
+                is_visited = true;
+            });
+            assert(is_visited);
+        } catch (...) {
+            assert(false);
+        }
+    }
+
+    return 0;
+}
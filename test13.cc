@@ -0,0 +1,113 @@
+#include "ret-exception-charconv.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+
+namespace charconv = ret_exception::charconv;
+
+int main(int argc, char* argv[])
+{
+    // Test from_chars
+    try {
+        assert(charconv::from_chars<int>("123").get_return_value() == 123);
+        assert(charconv::from_chars<int>("-2147483648").get_return_value() == -2147483648);
+        assert(charconv::from_chars<double>("1.5").get_return_value() == 1.5);
+        assert(charconv::from_chars<float>("-0.25").get_return_value() == -0.25f);
+        assert(charconv::from_chars<int>("ff", nullptr, 16).get_return_value() == 255);
+
+        assert(charconv::from_chars<int>("2147483648").get_error_if<charconv::out_of_range_t>()->position == 0);
+        assert(charconv::from_chars<unsigned>("-1").get_error_if<charconv::invalid_argument_t>()->position == 0);
+        assert(charconv::from_chars<int>("12x").get_error_if<charconv::invalid_argument_t>()->position == 2);
+        assert(charconv::from_chars<double>("1e999").get_error_if<charconv::out_of_range_t>());
+        assert(charconv::from_chars<int>("zz", nullptr, 16).get_error_if<charconv::invalid_argument_t>());
+
+        // Integer part overflowing the mantissa must not take the exact path
+        assert(charconv::from_chars<double>("18446744073709551616.5").get_return_value() ==
+               std::strtod("18446744073709551616.5", nullptr));
+        assert(charconv::from_chars<double>("36893488147419103232.25e1").get_return_value() ==
+               std::strtod("36893488147419103232.25e1", nullptr));
+
+        std::size_t consumed;
+        assert(charconv::from_chars<int>("12x", &consumed).get_return_value() == 12);
+        assert(consumed == 2);
+        assert(charconv::from_chars<double>("2.5e1,", &consumed).get_return_value() == 25);
+        assert(consumed == 5);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test from_chars_bulk
+    try {
+        int values[8];
+        assert(charconv::from_chars_bulk("1,-2,3,", ',', values, 8).get_return_value() == 3);
+        assert(values[0] == 1 && values[1] == -2 && values[2] == 3);
+
+        assert(charconv::from_chars_bulk("1,2,3", ',', values, 2).get_return_value() == 2);
+        assert(charconv::from_chars_bulk("", ',', values, 8).get_return_value() == 0);
+
+        auto r = charconv::from_chars_bulk("10,20,x", ',', values, 8);
+        assert(r.get_error_if<charconv::invalid_argument_t>()->position == 6);
+        assert(values[1] == 20);
+
+        auto r2 = charconv::from_chars_bulk("10,99999999999,1", ',', values, 8);
+        assert(r2.get_error_if<charconv::out_of_range_t>()->position == 3);
+
+        auto r3 = charconv::from_chars_bulk("10;20", ',', values, 8);
+        assert(r3.get_error_if<charconv::invalid_argument_t>()->position == 2);
+
+        double doubles[4];
+        assert(charconv::from_chars_bulk("0.5 1e3 -2", ' ', doubles, 4).get_return_value() == 3);
+        assert(doubles[0] == 0.5 && doubles[1] == 1000 && doubles[2] == -2);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test to_chars and to_chars_bulk
+    try {
+        char buf[32];
+        char *end = charconv::to_chars(buf, buf + sizeof(buf), -42).get_return_value();
+        assert((std::string_view{buf, static_cast<std::size_t>(end - buf)} == "-42"));
+
+        end = charconv::to_chars(buf, buf + sizeof(buf), 0.1).get_return_value();
+        assert((std::string_view{buf, static_cast<std::size_t>(end - buf)} == "0.1"));
+
+        assert(charconv::to_chars(buf, buf + 2, 12345).get_error_if<charconv::out_of_range_t>()->position == 2);
+
+        const int values[] = {1, 22, 333};
+        end = charconv::to_chars_bulk(buf, buf + sizeof(buf), values, 3, ',').get_return_value();
+        assert((std::string_view{buf, static_cast<std::size_t>(end - buf)} == "1,22,333"));
+
+        assert(charconv::to_chars_bulk(buf, buf + 4, values, 3, ',').get_error_if<charconv::out_of_range_t>());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test float_to_int and int_to_float
+    try {
+        assert(charconv::float_to_int<int>(-1.9).get_return_value() == -1);
+        assert(charconv::float_to_int<std::int8_t>(-128.9f).get_return_value() == -128);
+        assert(charconv::float_to_int<std::int8_t>(127.9).get_return_value() == 127);
+        assert(charconv::float_to_int<std::int8_t>(128.0).get_error_if<charconv::out_of_range_t>());
+        assert(charconv::float_to_int<unsigned>(-1.0).get_error_if<charconv::out_of_range_t>());
+        assert(charconv::float_to_int<unsigned>(-0.5).get_return_value() == 0);
+        assert(charconv::float_to_int<std::int64_t>(-9223372036854775808.0).get_return_value() ==
+               std::numeric_limits<std::int64_t>::min());
+        assert(charconv::float_to_int<std::int64_t>(9223372036854775808.0).get_error_if<charconv::out_of_range_t>());
+        assert(charconv::float_to_int<int>(std::nan("")).get_error_if<charconv::invalid_argument_t>());
+        assert(charconv::float_to_int<int>(INFINITY).get_error_if<charconv::out_of_range_t>());
+
+        assert(charconv::int_to_float<float>(16777216).get_return_value() == 16777216.0f);
+        assert(charconv::int_to_float<float>(16777217).get_error_if<charconv::out_of_range_t>());
+        assert(charconv::int_to_float<double>(std::numeric_limits<std::int64_t>::max())
+                   .get_error_if<charconv::out_of_range_t>());
+        assert(charconv::int_to_float<double>(std::numeric_limits<std::int64_t>::min()).get_return_value() ==
+               -9223372036854775808.0);
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "ret-exception-error-code.hpp"
+#include "ret-exception-io.hpp"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+struct not_found {};
+
+struct throwing_category: std::error_category {
+    auto name() const noexcept -> const char* override
+    {
+        return "throwing";
+    }
+
+    auto message(int) const -> std::string override
+    {
+        throw std::bad_alloc{};
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    static_assert(std::is_trivially_copyable_v<ret_exception::error_code_t>);
+
+    // Test make_error_code
+    {
+        std::error_code ec = ret_exception::make_error_code(ret_exception::error_code_t{
+            std::make_error_code(std::errc::permission_denied)});
+        assert(ec == std::errc::permission_denied);
+
+        ec = ret_exception::make_error_code(std::system_error{std::make_error_code(std::errc::timed_out)});
+        assert(ec == std::errc::timed_out);
+
+        ec = ret_exception::make_error_code(ret_exception::io::sys_error{std::errc::no_such_file_or_directory});
+        assert(ec == std::errc::no_such_file_or_directory);
+
+        ec = ret_exception::make_error_code(ret_exception::io::would_block{});
+        assert(ec == std::errc::operation_would_block);
+
+        ec = ret_exception::make_error_code(not_found{});
+        assert(ec.value() == 1);
+        assert(ec.category() == ret_exception::make_error_code(not_found{}).category());
+        assert(ec.category() != ret_exception::make_error_code(3).category());
+        assert(ec.message() == "not_found");
+    }
+
+    // Test what() is formatted on demand
+    try {
+        ret_exception::error_code_t e{std::make_error_code(std::errc::permission_denied)};
+        assert(std::strcmp(e.what(), std::make_error_code(std::errc::permission_denied).message().c_str()) == 0);
+
+        static const throwing_category category;
+        static_assert(noexcept(e.what()));
+        assert(std::strcmp(ret_exception::error_code_t{std::error_code{1, category}}.what(), "throwing") == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test to_error_code
+    try {
+        Ret_except<int, not_found, ret_exception::io::sys_error> r{ret_exception::io::sys_error{std::errc::io_error}};
+        assert(ret_exception::to_error_code(r) == std::errc::io_error);
+        assert(r.has_exception_handled());
+
+        Ret_except<int, not_found> r2{1};
+        assert(!ret_exception::to_error_code(r2));
+    } catch (...) {
+        assert(false);
+    }
+
+#if __cpp_lib_expected >= 202202L
+    // Test to_expected
+    try {
+        auto e = ret_exception::to_expected(Ret_except<int, not_found>{not_found{}});
+        assert(!e.has_value());
+        assert(e.error() == ret_exception::make_error_code(not_found{}));
+
+        auto e2 = ret_exception::to_expected(Ret_except<int, not_found>{2});
+        assert(e2.value() == 2);
+
+        auto e3 = ret_exception::to_expected(Ret_except<void, not_found>{});
+        assert(e3.has_value());
+    } catch (...) {
+        assert(false);
+    }
+#endif
+
+    // Test from_error_code and invoke_with_error_code
+    try {
+        assert(!ret_exception::from_error_code({}).has_exception_set());
+
+        bool is_visited = false;
+        ret_exception::from_error_code(std::make_error_code(std::errc::interrupted))
+            .Catch([&](ret_exception::error_code_t e) {
+                assert(e.code() == std::errc::interrupted);
+                is_visited = true;
+            });
+        assert(is_visited);
+
+        is_visited = false;
+        ret_exception::invoke_with_error_code([](const std::filesystem::path &path, std::error_code &ec) {
+            return std::filesystem::file_size(path, ec);
+        }, "/nonexistent/file").Catch([&](ret_exception::error_code_t e) {
+            assert(e.code() == std::errc::no_such_file_or_directory);
+            is_visited = true;
+        });
+        assert(is_visited);
+
+        auto exists = ret_exception::invoke_with_error_code([](const char *path, std::error_code &ec) {
+            return std::filesystem::exists(path, ec);
+        }, "/");
+        assert(exists.get_return_value());
+
+        assert(!ret_exception::invoke_with_error_code([](std::error_code &ec) {
+            ec.clear();
+        }).has_exception_set());
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
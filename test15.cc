@@ -0,0 +1,183 @@
+#include "ret-exception.hpp"
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+
+using ret_exception::any_error;
+
+struct not_found {
+    int key;
+};
+
+struct timeout {
+    long ms;
+};
+
+/**
+ * Too large to be stored inline.
+ */
+struct large_error {
+    char msg[64];
+};
+
+static int destroyed = 0;
+
+struct counted {
+    int val;
+
+    counted(int val): val{val} {}
+    counted(counted &&other) noexcept: val{other.val} { other.val = -1; }
+    ~counted() { if (val != -1) ++destroyed; }
+};
+
+using typed_result = Ret_except<int, not_found, timeout>;
+using erased_result = Ret_except<int, any_error>;
+
+static auto lookup(int key) -> typed_result
+{
+    if (key < 0)
+        return {not_found{key}};
+    if (key == 0)
+        return {timeout{100}};
+    return {key * 2};
+}
+
+static auto erased_lookup(int key) -> erased_result
+{
+    return {lookup(key)};
+}
+
+int main(int argc, char* argv[])
+{
+    static_assert(ret_exception::type_hash_v<not_found> != ret_exception::type_hash_v<timeout>);
+    static_assert(ret_exception::type_hash_v<not_found> == ret_exception::type_hash_v<not_found>);
+
+    // Inline and allocated storage
+    {
+        any_error e{not_found{3}};
+        assert(e.holds<not_found>());
+        assert(!e.holds<timeout>());
+        assert(e.get_if<not_found>()->key == 3);
+        assert(e.get_if<timeout>() == nullptr);
+        assert(e.payload() == static_cast<void*>(e.get_if<not_found>()));
+        assert(std::strncmp(e.type().name, "not_found", e.type().name_len) == 0);
+
+        large_error large{};
+        std::strcpy(large.msg, "large");
+        any_error l{large};
+        assert(std::strcmp(l.get_if<large_error>()->msg, "large") == 0);
+
+        any_error moved{std::move(l)};
+        assert(!l.holds<large_error>());
+        assert(std::strcmp(moved.get_if<large_error>()->msg, "large") == 0);
+
+        moved = std::move(e);
+        assert(moved.get_if<not_found>()->key == 3);
+
+        char buf[32];
+        any_error i{-5};
+        assert(std::strcmp(i.describe(buf), "-5") == 0);
+    }
+
+    // Payload is destroyed exactly once
+    {
+        {
+            any_error e{counted{1}};
+            any_error moved{std::move(e)};
+        }
+        assert(destroyed == 1);
+    }
+
+    // Typed to any_error and Catch by the type inside
+    try {
+        assert(erased_lookup(2).get_return_value() == 4);
+
+        int key = 0;
+        erased_lookup(-3).Catch([&](const timeout&) {
+            assert(false);
+        }).Catch([&](const not_found &e) {
+            key = e.key;
+        });
+        assert(key == -3);
+
+        long ms = 0;
+        erased_lookup(0).Catch([&](const not_found&) {
+            assert(false);
+        }, [&](timeout e) {
+            ms = e.ms;
+        }, [&](const any_error&) {
+            assert(false);
+        });
+        assert(ms == 100);
+
+        bool is_visited = false;
+        erased_lookup(0).Catch([&](const any_error &e) {
+            is_visited = e.holds<timeout>();
+        });
+        assert(is_visited);
+
+        auto r = erased_lookup(-1);
+        assert(r.has_exception_type<not_found>());
+        assert(!r.has_exception_type<timeout>());
+        assert(r.get_error_if<not_found>()->key == -1);
+    } catch (...) {
+        assert(false);
+    }
+
+    // any_error back to typed is lossless
+    try {
+        typed_result r{erased_lookup(-7)};
+        assert(r.get_error_if<not_found>()->key == -7);
+
+        typed_result r2{erased_lookup(0)};
+        assert(r2.get_error_if<timeout>()->ms == 100);
+
+        typed_result r3{erased_lookup(5)};
+        assert(r3.get_return_value() == 10);
+    } catch (...) {
+        assert(false);
+    }
+
+    // any_error holding exception not in Ts... is left in the source
+    try {
+        erased_result src{any_error{large_error{}}};
+        typed_result r{std::move(src)};
+        assert(!r.has_exception_set());
+        assert(!src.has_exception_handled());
+        assert(src.has_exception_type<large_error>());
+
+        src.Catch([](const large_error&) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    // Catch_all_exhaustive
+    {
+        int ret = erased_lookup(-2).Catch_all_exhaustive([](const not_found &e) {
+            return e.key;
+        }, [](const any_error&) {
+            return 0;
+        });
+        assert(ret == -2);
+
+        ret = erased_lookup(0).Catch_all_exhaustive([](const not_found &e) {
+            return e.key;
+        }, [](const any_error&) {
+            return 0;
+        });
+        assert(ret == 0);
+    }
+
+    // Unhandled any_error throws the exception inside
+    try {
+        {
+            Ret_except<void, any_error> r{any_error{std::runtime_error{"inside"}}};
+        }
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::strcmp(e.what(), "inside") == 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "ret-exception.hpp"
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+
+using ret_exception::deferred;
+
+static int constructed = 0;
+
+struct request_failed {
+    std::string msg;
+
+    request_failed(int id, const std::string &reason):
+        msg{"request " + std::to_string(id) + ": " + reason}
+    {
+        ++constructed;
+    }
+
+    auto what() const noexcept -> const char*
+    {
+        return msg.c_str();
+    }
+};
+
+struct busy {};
+
+using result = Ret_except<int, deferred<request_failed>, busy>;
+
+static auto request(int id) -> result
+{
+    if (id < 0)
+        return {ret_exception::defer<request_failed>(id, "negative id")};
+    if (id == 0)
+        return {busy{}};
+    return {id};
+}
+
+int main(int argc, char* argv[])
+{
+    // Type check does not construct the payload
+    try {
+        auto r = request(-1);
+        assert(r.has_exception_type<request_failed>());
+        assert(r.has_exception_type<deferred<request_failed>>());
+        assert(!r.has_exception_type<busy>());
+
+        r.Catch([](const deferred<request_failed>&) {});
+        assert(constructed == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Handler taking the full type constructs it
+    try {
+        std::string msg;
+        request(-2).Catch([&](const request_failed &e) {
+            msg = e.what();
+        });
+        assert(msg == "request -2: negative id");
+        assert(constructed == 1);
+
+        request(-3).Catch([&](busy) {
+            assert(false);
+        }, [&](const request_failed &e) {
+            msg = e.what();
+        });
+        assert(msg == "request -3: negative id");
+        assert(constructed == 2);
+
+        int ret = request(-4).Catch_all_exhaustive([](busy) {
+            return 0;
+        }, [](const request_failed &e) {
+            return static_cast<int>(std::strlen(e.what()));
+        });
+        assert(ret == static_cast<int>(std::strlen("request -4: negative id")));
+        assert(constructed == 3);
+    } catch (...) {
+        assert(false);
+    }
+
+    static_assert(result::catches_all<void (*)(busy), void (*)(const request_failed&)>());
+
+    // Recipe from a callable
+    try {
+        int id = 7;
+        Ret_except<void, deferred<std::runtime_error>> r{deferred<std::runtime_error>{[id] {
+            return std::runtime_error{"failed " + std::to_string(id)};
+        }}};
+
+        std::string msg;
+        r.Catch([&](const std::runtime_error &e) {
+            msg = e.what();
+        });
+        assert(msg == "failed 7");
+    } catch (...) {
+        assert(false);
+    }
+
+    // Converted to Ret_except holding the full type
+    try {
+        Ret_except<int, request_failed, busy> r{request(-5)};
+        assert(std::strcmp(r.get_error_if<request_failed>()->what(), "request -5: negative id") == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Unhandled deferred throws the full type
+    try {
+        {
+            auto r = request(-6);
+        }
+        assert(false);
+    } catch (const request_failed &e) {
+        assert(std::strcmp(e.what(), "request -6: negative id") == 0);
+    }
+
+    return 0;
+}
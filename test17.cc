@@ -0,0 +1,140 @@
+#include "ret-exception.hpp"
+#include <cassert>
+#include <cstring>
+
+using ret_exception::context_t;
+
+struct not_found {
+    int key;
+};
+
+static auto lookup(int key) -> Ret_except<int, not_found>
+{
+    if (key < 0)
+        return {not_found{key}};
+    return {key};
+}
+
+static auto get_field(int key) -> Ret_except<int, not_found>
+{
+    return lookup(key).add_context({"while reading field", key});
+}
+
+static auto handle_request(int id, int key) -> Ret_except<long, not_found, int>
+{
+    return {get_field(key).add_context({"in request", id})};
+}
+
+static std::size_t count_context()
+{
+    std::size_t n = 0;
+    ret_exception::for_each_context([&](const context_t&) {
+        ++n;
+    });
+    return n;
+}
+
+int main(int argc, char* argv[])
+{
+    char buf[128];
+
+    // Nothing is attached on success
+    try {
+        assert(handle_request(1, 2).get_return_value() == 2);
+        assert(count_context() == 0);
+        assert(ret_exception::format_context(buf, sizeof(buf)) == 0);
+        assert(buf[0] == '\0');
+    } catch (...) {
+        assert(false);
+    }
+
+    // Context is chained across frames and cleared once handled
+    try {
+        auto r = handle_request(7, -3);
+        assert(count_context() == 2);
+
+        ret_exception::format_context(buf, sizeof(buf));
+        assert(std::strcmp(buf, "while reading field -3; in request 7") == 0);
+
+        r.Catch([&](const not_found &e) {
+            assert(e.key == -3);
+        });
+        assert(count_context() == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Label without value and truncation
+    try {
+        auto r = lookup(-1).add_context("in main");
+        assert(ret_exception::format_context(buf, 4) == 3);
+        assert(std::strcmp(buf, "in ") == 0);
+
+        assert(r.value_or(0) == 0);
+        assert(count_context() == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Contexts beyond the capacity are counted
+    try {
+        auto r = lookup(-1);
+        for (int i = 0; i != 20; ++i)
+            r.add_context({"depth", i});
+
+        assert(count_context() == ret_exception::impl::context_chain_t::capacity);
+        assert(ret_exception::for_each_context([](const context_t&) {}) == 4);
+
+        char large_buf[512];
+        std::size_t len = ret_exception::format_context(large_buf, sizeof(large_buf));
+        assert(std::strcmp(large_buf + len - std::strlen("; 4 more"), "; 4 more") == 0);
+
+        assert(r.get_error_if<not_found>());
+        assert(count_context() == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Context of an exception thrown or dropped is cleared
+    try {
+        {
+            auto r = lookup(-1).add_context("thrown");
+        }
+        assert(false);
+    } catch (const not_found &e) {
+        assert(e.key == -1);
+    }
+    assert(count_context() == 0);
+
+    {
+        Ret_except_p<ret_exception::checked_once_policy, int, not_found> r{not_found{-1}};
+        r.add_context("dropped");
+        assert(count_context() == 1);
+    }
+    assert(count_context() == 0);
+
+    // Context is kept when the exception is moved
+    try {
+        auto r = lookup(-1).add_context({"first", 1});
+        auto moved = std::move(r);
+        assert(count_context() == 1);
+
+        moved.Catch([](const not_found&) {});
+        assert(count_context() == 0);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Default constructed context has no label
+    try {
+        auto r = lookup(-1).add_context(context_t{});
+        assert(ret_exception::format_context(buf, sizeof(buf)) == 0);
+        assert(buf[0] == '\0');
+
+        r.Catch([](const not_found&) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
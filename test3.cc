@@ -2,6 +2,8 @@
 #include <type_traits>
 #include <stdexcept>
 #include <cassert>
+#include <mutex>
+#include <vector>
 
 class A {
 public:
@@ -18,6 +20,71 @@ public:
     B(Ret_except_t &e);
 };
 
+struct Timeout {};
+struct Refused {};
+
+/**
+ * Large, non-movable and fails in ctor.
+ */
+class Connection {
+public:
+    using Ret_except_t = Ret_except<void, Timeout, Refused>;
+
+    std::mutex mutex;
+    char buffer[4096];
+    int port;
+
+    Connection(Ret_except_t &e, int port):
+        port{port}
+    {
+        if (port < 0)
+            e = Ret_except_t{Refused{}};
+    }
+    Connection(Connection&&) = delete;
+};
+
+class Pool {
+public:
+    std::mutex mutex;
+    int size;
+
+    explicit Pool(int size): size{size} {}
+    Pool(Pool&&) = delete;
+
+    static auto try_create(int size) -> Ret_except<Pool, Refused>
+    {
+        if (size < 0)
+            return {Refused{}};
+        return {std::in_place_type<Pool>, size};
+    }
+};
+
+/**
+ * Neither copyable nor movable.
+ */
+struct Big {
+    std::mutex mutex;
+    char buffer[4096];
+    int id;
+};
+
+auto find(std::vector<int> &v, int x) -> Ret_except<int&, std::out_of_range>
+{
+    for (int &e: v)
+        if (e == x)
+            return {e};
+    return {std::out_of_range{"not found"}};
+}
+
+#if RET_EXCEPTION_ELIDES_CONVERSION
+auto make_big(int id) -> Ret_except<Big, std::invalid_argument>
+{
+    if (id < 0)
+        return {std::invalid_argument{"negative id"}};
+    return {ret_exception::in_place_invoke, [&] { return Big{{}, {}, id}; }};
+}
+#endif
+
 int main(int argc, char* argv[])
 {
     static_assert(std::is_constructible_v<A, Ret_except_detector_t>);
@@ -83,5 +150,90 @@ int main(int argc, char* argv[])
         assert(false);
     }
 
+    // try_make via fallible ctor
+    static_assert(std::is_same_v<decltype(ret_exception::try_make<Connection>(1)),
+                                 Ret_except<Connection, Timeout, Refused>>);
+    try {
+        auto conn = ret_exception::try_make<Connection>(80);
+        assert(conn.get_return_value().port == 80);
+
+        bool is_visited = false;
+        ret_exception::try_make<Connection>(-1).Catch([&](Refused) {
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+
+    // try_make via try_create
+    try {
+        auto pool = ret_exception::try_make<Pool>(4);
+        assert(pool.get_return_value().size == 4);
+
+        bool is_visited = false;
+        ret_exception::try_make<Pool>(-1).Catch([&](Refused) {
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+
+    // try_make of infallible type
+    try {
+        static_assert(std::is_same_v<decltype(ret_exception::try_make<std::mutex>()), Ret_except<std::mutex>>);
+        auto m = ret_exception::try_make<std::mutex>();
+        m.get_return_value().lock();
+        m.get_return_value().unlock();
+    } catch (...) {
+        assert(false);
+    }
+
+    // reference as return value
+    try {
+        std::vector<int> v{1, 2, 3};
+
+        auto r = find(v, 2);
+        assert(&r.get_return_value() == &v[1]);
+        assert(r.get_if() == &v[1]);
+        r.get_return_value() = 4;
+        assert(v[1] == 4);
+
+        int &e = find(v, 3);
+        assert(&e == &v[2]);
+
+        int other = 0;
+        assert(&find(v, 5).value_or(other) == &other);
+    } catch (...) {
+        assert(false);
+    }
+
+    // return value constructed in place
+    try {
+        Ret_except<std::vector<int>, std::invalid_argument> r{ret_exception::in_place_invoke, [] {
+            return std::vector<int>(3, 1);
+        }};
+        assert(r.get_return_value().size() == 3);
+    } catch (...) {
+        assert(false);
+    }
+
+#if RET_EXCEPTION_ELIDES_CONVERSION
+    // non-movable return value constructed in place
+    try {
+        auto big = make_big(3);
+        assert(big.get_return_value().id == 3);
+
+        bool is_visited = false;
+        make_big(-1).Catch([&](const std::invalid_argument&) {
+            is_visited = true;
+        });
+        assert(is_visited);
+    } catch (...) {
+        assert(false);
+    }
+#endif
+
     return 0;
 }
@@ -199,6 +199,12 @@ struct variant_non_member_functions_t<test::variant> {
         else
             return val;
     }
+
+    template <class T, class ...Ts>
+    static constexpr auto get_if(test::variant<Ts...> *v) noexcept -> T*
+    {
+        return holds_alternative<T>(*v) ? &v->template get_impl<T>() : nullptr;
+    }
 };
 } /* namespace ret_exception::impl */
 
@@ -352,5 +358,34 @@ int main(int argc, char* argv[])
         assert(false);
     }
 
+    // Test get_if + value_or + get_error_if
+    try {
+        Ret_except_test<char, int, void*> r{'c'};
+        assert(*r.get_if() == 'c');
+        assert(r.get_error_if<int>() == nullptr);
+        assert(r.value_or('d') == 'c');
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        Ret_except_test<char, int, void*> r{-1};
+        assert(r.get_if() == nullptr);
+        assert(r.get_error_if<void*>() == nullptr);
+        assert(!r.has_exception_handled());
+        assert(*r.get_error_if<int>() == -1);
+        assert(r.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+    try {
+        Ret_except_test<char, int, void*> r{-1};
+        assert(r.value_or('d') == 'd');
+        assert(r.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
     return 0;
 }
@@ -0,0 +1,95 @@
+#include "ret-exception.hpp"
+#include <limits>
+#include <type_traits>
+
+struct invalid_argument {
+    const char *msg;
+};
+struct out_of_range {
+    int sign;
+};
+
+template <class T>
+constexpr auto checked_cast(long long i) noexcept -> Ret_except<T, invalid_argument, out_of_range>
+{
+    if (i < 0 && std::is_unsigned_v<T>)
+        return {invalid_argument{"i should not be negative"}};
+    else if (i > static_cast<long long>(std::numeric_limits<T>::max()))
+        return {out_of_range{1}};
+    else if (i < static_cast<long long>(std::numeric_limits<T>::min()))
+        return {out_of_range{-1}};
+    return static_cast<T>(i);
+}
+
+template <class T>
+constexpr auto checked_cast_or(long long i, T fallback) -> T
+{
+    auto r = checked_cast<T>(i);
+    T ret = fallback;
+
+    r.Catch([&](const out_of_range &e) {
+        ret = e.sign > 0 ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+    }).Catch([](const auto&) {});
+
+    if (!r.has_exception_set())
+        ret = r.get_return_value();
+    return ret;
+}
+
+constexpr auto propagate(long long i) -> Ret_except<short, out_of_range, invalid_argument, int>
+{
+    return {checked_cast<signed char>(i)};
+}
+
+constexpr auto set_then_get() -> int
+{
+    Ret_except<int, char> r;
+    r.set_exception<char>('c');
+
+    bool is_visited = false;
+    r.Catch([&](char c) {
+        is_visited = c == 'c';
+    });
+
+    r.set_return_value(is_visited ? 2 : 1);
+    return r;
+}
+
+template <class T>
+constexpr auto table_of_casts() -> bool
+{
+    for (long long i = -300; i != 300; ++i) {
+        auto r = checked_cast<T>(i);
+        bool in_range = i >= std::numeric_limits<T>::min() && i <= std::numeric_limits<T>::max();
+        if (r.has_exception_set() == in_range)
+            return false;
+        r.Catch([](const auto&) {});
+    }
+    return true;
+}
+
+// A constant expression is required here, so an unhandled exception would not compile.
+template <long long i>
+constexpr auto must_succeed = checked_cast<unsigned char>(i).get_return_value();
+
+int main(int argc, char* argv[])
+{
+    static_assert(checked_cast_or<unsigned char>(20, 0) == 20);
+    static_assert(checked_cast_or<unsigned char>(-1, 7) == 7);
+    static_assert(checked_cast_or<unsigned char>(300, 0) == 255);
+    static_assert(checked_cast_or<signed char>(-300, 0) == -128);
+
+    static_assert(propagate(100).get_return_value() == 100);
+    static_assert(propagate(1000).Catch([](const out_of_range&) {}).has_exception_handled());
+
+    static_assert(set_then_get() == 2);
+
+    static_assert(table_of_casts<unsigned char>());
+    static_assert(table_of_casts<signed char>());
+
+    static_assert(must_succeed<42> == 42);
+
+    // The same functions are still usable at runtime.
+    volatile long long i = 1000;
+    return checked_cast_or<unsigned char>(i, 0) == 255 ? 0 : 1;
+}
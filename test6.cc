@@ -0,0 +1,37 @@
+#include "ret-exception.hpp"
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+[[noreturn]] void handler(const ret_exception::type_id_t &type, const void *payload) noexcept
+{
+    char buf[32];
+
+    if (&type != &ret_exception::type_id_v<std::out_of_range>)
+        std::_Exit(1);
+    if (std::strncmp(type.name, "std::out_of_range", type.name_len) != 0)
+        std::_Exit(2);
+    if (std::strcmp(static_cast<const std::out_of_range*>(payload)->what(), "too large") != 0)
+        std::_Exit(3);
+    if (std::strcmp(type.describe(payload, buf), "too large") != 0)
+        std::_Exit(4);
+
+    std::_Exit(42);
+}
+
+int main(int argc, char* argv[])
+{
+    char buf[32];
+    long l = -1;
+
+    if (std::strcmp(ret_exception::type_id_v<long>.describe(&l, buf), "-1") != 0)
+        return 1;
+    if (ret_exception::get_unhandled_exception_handler() != &ret_exception::minimal_handler)
+        return 1;
+
+    ret_exception::set_unhandled_exception_handler(&handler);
+
+    Ret_except<void, int, std::out_of_range>{std::out_of_range{"too large"}};
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "ret-exception-shared.hpp"
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+
+struct NotFound {
+    int key;
+};
+struct Timeout {};
+
+using result_t = ret_exception::shared_result<std::string, NotFound, Timeout>;
+
+int main(int argc, char* argv[])
+{
+    // Test publish once + many readers of the return value
+    try {
+        result_t cell;
+        assert(!cell.is_ready());
+        assert(cell.get_if() == nullptr);
+
+        std::atomic<int> cnt{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i != 8; ++i)
+            readers.emplace_back([&] {
+                cell.wait();
+                assert(*cell.get_if() == "value");
+                assert(!cell.has_exception_set());
+                ++cnt;
+            });
+
+        bool is_published = cell.publish(Ret_except<std::string, NotFound, Timeout>{std::string{"value"}});
+        assert(is_published);
+        is_published = cell.publish(Ret_except<std::string, NotFound, Timeout>{std::string{"other"}});
+        assert(!is_published);
+
+        for (auto &reader: readers)
+            reader.join();
+        assert(cnt == 8);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test many readers observing the same exception
+    try {
+        result_t cell;
+        bool is_published = cell.publish(Ret_except<std::string, NotFound, Timeout>{NotFound{3}});
+        assert(is_published);
+
+        std::atomic<int> cnt{0};
+        std::vector<std::thread> readers;
+        for (int i = 0; i != 8; ++i)
+            readers.emplace_back([&] {
+                assert(cell.has_exception_type<NotFound>());
+                cell.Catch([&](const Timeout&) {
+                    assert(false);
+                }, [&](const NotFound &e) {
+                    assert(e.key == 3);
+                    ++cnt;
+                });
+            });
+
+        for (auto &reader: readers)
+            reader.join();
+        assert(cnt == 8);
+        assert(cell.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test get_error_if marks the exception handled
+    try {
+        result_t cell;
+        bool is_published = cell.publish(Ret_except<std::string, NotFound, Timeout>{Timeout{}});
+        assert(is_published);
+        auto *not_found = cell.get_error_if<NotFound>();
+        assert(not_found == nullptr);
+        assert(!cell.has_exception_handled());
+        auto *timeout = cell.get_error_if<Timeout>();
+        assert(timeout != nullptr);
+        assert(cell.has_exception_handled());
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test unhandled exception is thrown in dtor
+    try {
+        result_t cell;
+        bool is_published = cell.publish(Ret_except<std::string, NotFound, Timeout>{NotFound{1}});
+        assert(is_published);
+        cell.Catch([](const Timeout&) {});
+    } catch (const NotFound &e) {
+        assert(e.key == 1);
+    }
+
+    return 0;
+}
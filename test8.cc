@@ -0,0 +1,153 @@
+#include "ret-exception-memoize.hpp"
+#include <cassert>
+#include <atomic>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+
+struct NotFound {
+    int key;
+};
+struct Timeout {};
+
+static std::atomic<int> calls{0};
+
+static auto lookup(int key) -> Ret_except<std::string, NotFound, Timeout>
+{
+    ++calls;
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    if (key < 0)
+        return {NotFound{key}};
+    return std::to_string(key);
+}
+
+int main(int argc, char* argv[])
+{
+    // Test cached return value + single-flight
+    try {
+        calls = 0;
+        auto cached_lookup = ret_exception::memoize(lookup);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i != 8; ++i)
+            threads.emplace_back([&] {
+                assert(cached_lookup(1).get_return_value() == "1");
+            });
+        for (auto &thread: threads)
+            thread.join();
+        assert(calls == 1);
+
+        assert(cached_lookup(1).get_return_value() == "1");
+        assert(cached_lookup(2).get_return_value() == "2");
+        assert(calls == 2);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test cached exception, each caller gets its own exception to handle
+    try {
+        calls = 0;
+        ret_exception::memoize_options options;
+        options.error_ttl = std::chrono::milliseconds{50};
+        auto cached_lookup = ret_exception::memoize(lookup, options);
+
+        for (int i = 0; i != 3; ++i) {
+            bool is_visited = false;
+            cached_lookup(-1).Catch([&](const NotFound &e) {
+                assert(e.key == -1);
+                is_visited = true;
+            }).Catch([](const auto&) {
+                assert(false);
+            });
+            assert(is_visited);
+        }
+        assert(calls == 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{60});
+        auto r = cached_lookup(-1);
+        assert(r.has_exception_type<NotFound>() == true);
+        r.Catch([](const NotFound&) {});
+        assert(calls == 2);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test exception is not cached
+    try {
+        calls = 0;
+        ret_exception::memoize_options options;
+        options.cache_errors = false;
+        auto cached_lookup = ret_exception::memoize(lookup, options);
+
+        cached_lookup(-1).Catch([](const auto&) {});
+        cached_lookup(-1).Catch([](const auto&) {});
+        assert(calls == 2);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test exception thrown by the function is not cached and the waiters call it again
+    try {
+        calls = 0;
+        auto cached_lookup = ret_exception::memoize([](int key) -> Ret_except<int, NotFound> {
+            if (calls++ == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                throw std::runtime_error{"first call"};
+            }
+            return {key};
+        });
+
+        std::atomic<int> thrown{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i != 4; ++i)
+            threads.emplace_back([&] {
+                try {
+                    assert(cached_lookup(1).get_return_value() == 1);
+                } catch (const std::runtime_error&) {
+                    ++thrown;
+                }
+            });
+        for (auto &thread: threads)
+            thread.join();
+
+        assert(thrown == 1);
+        assert(calls == 2);
+        assert(cached_lookup(1).get_return_value() == 1);
+        assert(calls == 2);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test CLOCK eviction keeps the number of results bounded
+    try {
+        calls = 0;
+        ret_exception::memoize_options options;
+        options.capacity = 2;
+        options.shards = 1;
+        auto cached_lookup = ret_exception::memoize([](int key) {
+            ++calls;
+            return Ret_except<int, NotFound>{key};
+        }, options);
+
+        assert(cached_lookup(1).get_return_value() == 1);
+        assert(cached_lookup(2).get_return_value() == 2);
+        assert(cached_lookup(3).get_return_value() == 3);
+        assert(calls == 3);
+
+        // 3 is the most recently inserted and must still be cached
+        assert(cached_lookup(3).get_return_value() == 3);
+        assert(calls == 3);
+
+        // Only 2 can be cached, thus at least one of 1 and 2 is evicted
+        assert(cached_lookup(1).get_return_value() == 1);
+        assert(cached_lookup(2).get_return_value() == 2);
+        assert(calls >= 4);
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "ret-exception-retry.hpp"
+#include <cassert>
+#include <chrono>
+
+struct WouldBlock {};
+struct Interrupted {};
+struct PermissionDenied {};
+
+using lock_result = Ret_except<int, WouldBlock, Interrupted, PermissionDenied>;
+
+/**
+ * Fails with WouldBlock for the first failures calls.
+ */
+struct fake_lock {
+    int failures;
+    int calls = 0;
+
+    auto operator () () -> lock_result
+    {
+        if (calls++ < failures)
+            return {WouldBlock{}};
+        return calls;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    ret_exception::retry_policy no_backoff;
+    no_backoff.max_attempts = 5;
+    no_backoff.initial_backoff = std::chrono::nanoseconds{0};
+
+    // Test succeed after retry
+    try {
+        fake_lock lock{3};
+        auto r = ret_exception::retry<WouldBlock, Interrupted>(no_backoff, lock);
+        assert(r.get_return_value() == 4);
+        assert(lock.calls == 4);
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test give up after max_attempts, the last exception is returned
+    try {
+        fake_lock lock{10};
+        auto r = ret_exception::retry<WouldBlock>(no_backoff, lock);
+        assert(lock.calls == 5);
+        assert(r.has_exception_type<WouldBlock>());
+        assert(!r.has_exception_handled());
+        r.Catch([](WouldBlock) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test exception not retryable is returned at once
+    try {
+        int calls = 0;
+        auto r = ret_exception::retry<WouldBlock>(no_backoff, [&]() -> lock_result {
+            ++calls;
+            return {PermissionDenied{}};
+        });
+        assert(calls == 1);
+        assert(r.has_exception_type<PermissionDenied>());
+        r.Catch([](PermissionDenied) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test backoff
+    try {
+        ret_exception::retry_policy policy;
+        policy.max_attempts = 4;
+        policy.initial_backoff = std::chrono::milliseconds{2};
+        policy.jitter = 0;
+
+        fake_lock lock{3};
+        auto start = std::chrono::steady_clock::now();
+        auto r = ret_exception::retry<WouldBlock>(policy, lock);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        assert(r.get_return_value() == 4);
+        // 2ms + 4ms + 8ms
+        assert(elapsed >= std::chrono::milliseconds{14});
+    } catch (...) {
+        assert(false);
+    }
+
+    // Test deadline stops retrying before sleeping
+    try {
+        ret_exception::retry_policy policy;
+        policy.max_attempts = 10;
+        policy.initial_backoff = std::chrono::hours{1};
+        policy.deadline = std::chrono::seconds{1};
+
+        fake_lock lock{3};
+        auto r = ret_exception::retry<WouldBlock>(policy, lock);
+        assert(lock.calls == 1);
+        r.Catch([](WouldBlock) {});
+    } catch (...) {
+        assert(false);
+    }
+
+    return 0;
+}